@@ -0,0 +1,406 @@
+#pragma once
+
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Иерархия сжатия (contraction hierarchies).
+// Вершины сжимаются по возрастанию приоритета (разность рёбер + число сжатых соседей),
+// вместо каждой сжатой вершины добавляются рёбра-сокращения, если их не заменяет
+// свидетельский путь. Запрос - двунаправленный поиск только вверх по иерархии,
+// найденные сокращения разворачиваются обратно в EdgeId исходного графа
+template <typename Weight>
+class ContractionHierarchy {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+    using SearchWorkspace = typename DijkstraRouter<Weight>::Workspace;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+
+    // буферы прямого и обратного поиска
+    struct Workspace {
+        SearchWorkspace forward;
+        SearchWorkspace backward;
+    };
+
+    struct Stats {
+        std::chrono::nanoseconds preprocessing_time{0};
+        size_t original_edge_count = 0;
+        size_t shortcut_count = 0;
+    };
+
+    explicit ContractionHierarchy(const Graph& graph, size_t witness_settle_limit = 64);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, Workspace& workspace) const;
+
+    const Stats& GetStats() const {
+        return stats_;
+    }
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr EdgeId NO_EDGE = static_cast<EdgeId>(-1);
+
+    // ребро иерархии: исходное (second == NO_EDGE, first - EdgeId графа)
+    // или сокращение из двух рёбер иерархии first и second
+    struct HierarchyEdge {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId first;
+        EdgeId second;
+    };
+
+    // рёбра поиска в CSR: offsets[v]..offsets[v + 1] в edges
+    struct SearchGraph {
+        std::vector<size_t> offsets;
+        std::vector<EdgeId> edges;
+    };
+
+    size_t vertex_count_ = 0;
+    std::vector<HierarchyEdge> edges_;
+    std::vector<size_t> ranks_;
+    SearchGraph upward_;
+    SearchGraph downward_;
+    Stats stats_;
+
+    // состояние предобработки
+    struct Contraction {
+        std::vector<std::vector<EdgeId>> out_edges;
+        std::vector<std::vector<EdgeId>> in_edges;
+        std::vector<bool> contracted;
+        std::vector<size_t> contracted_neighbors;
+        SearchWorkspace witness;
+        size_t witness_settle_limit;
+    };
+
+    static std::vector<EdgeId> GetMinimalEdges(const std::vector<EdgeId>& edge_ids, const std::vector<HierarchyEdge>& edges,
+                                               const std::vector<bool>& contracted, VertexId vertex, bool by_target);
+    size_t ContractVertex(VertexId vertex, Contraction& state, bool simulate);
+    void RunWitnessSearch(VertexId source, VertexId excluded, Weight max_weight, Contraction& state) const;
+    void BuildSearchGraphs();
+    void UnpackEdge(EdgeId edge_id, std::vector<EdgeId>& result) const;
+};
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph, size_t witness_settle_limit)
+    : vertex_count_(graph.GetVertexCount())
+    , ranks_(graph.GetVertexCount(), 0)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Contraction state{
+        std::vector<std::vector<EdgeId>>(vertex_count_),
+        std::vector<std::vector<EdgeId>>(vertex_count_),
+        std::vector<bool>(vertex_count_, false),
+        std::vector<size_t>(vertex_count_, 0),
+        SearchWorkspace{},
+        witness_settle_limit
+    };
+
+    const size_t edge_count = graph.GetEdgeCount();
+    edges_.reserve(edge_count * 2);
+    for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        const auto& edge = graph.GetEdge(edge_id);
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+        if (edge.from == edge.to) {
+            continue;
+        }
+        edges_.push_back({edge.from, edge.to, edge.weight, edge_id, NO_EDGE});
+        state.out_edges[edge.from].push_back(edges_.size() - 1);
+        state.in_edges[edge.to].push_back(edges_.size() - 1);
+    }
+    stats_.original_edge_count = edges_.size();
+
+    // очередь сжатия с ленивым пересчётом приоритета
+    using QueueItem = std::pair<long long, VertexId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+    const auto priority = [&state, this](VertexId vertex) {
+        const long long shortcuts = static_cast<long long>(ContractVertex(vertex, state, true));
+        const long long removed = static_cast<long long>(state.out_edges[vertex].size() + state.in_edges[vertex].size());
+        return shortcuts - removed + static_cast<long long>(state.contracted_neighbors[vertex]);
+    };
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        queue.emplace(priority(vertex), vertex);
+    }
+
+    size_t rank = 0;
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (state.contracted[vertex]) {
+            continue;
+        }
+        const long long actual_priority = priority(vertex);
+        if (!queue.empty() && actual_priority > queue.top().first) {
+            queue.emplace(actual_priority, vertex);
+            continue;
+        }
+
+        stats_.shortcut_count += ContractVertex(vertex, state, false);
+        state.contracted[vertex] = true;
+        ranks_[vertex] = rank++;
+        // рёбра в сжатую вершину больше не участвуют ни в сжатии, ни в свидетельских поисках
+        for (const EdgeId edge_id : state.out_edges[vertex]) {
+            const VertexId neighbor = edges_[edge_id].to;
+            ++state.contracted_neighbors[neighbor];
+            auto& neighbor_edges = state.in_edges[neighbor];
+            neighbor_edges.erase(std::remove_if(neighbor_edges.begin(), neighbor_edges.end(), [this, vertex](EdgeId id) {
+                return edges_[id].from == vertex;
+            }), neighbor_edges.end());
+        }
+        for (const EdgeId edge_id : state.in_edges[vertex]) {
+            const VertexId neighbor = edges_[edge_id].from;
+            ++state.contracted_neighbors[neighbor];
+            auto& neighbor_edges = state.out_edges[neighbor];
+            neighbor_edges.erase(std::remove_if(neighbor_edges.begin(), neighbor_edges.end(), [this, vertex](EdgeId id) {
+                return edges_[id].to == vertex;
+            }), neighbor_edges.end());
+        }
+    }
+
+    BuildSearchGraphs();
+    stats_.preprocessing_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+// оставляет по одному самому лёгкому ребру до каждого несжатого соседа
+template <typename Weight>
+std::vector<EdgeId> ContractionHierarchy<Weight>::GetMinimalEdges(const std::vector<EdgeId>& edge_ids, const std::vector<HierarchyEdge>& edges,
+                                                                  const std::vector<bool>& contracted, VertexId vertex, bool by_target) {
+    std::vector<EdgeId> result;
+    result.reserve(edge_ids.size());
+    for (const EdgeId edge_id : edge_ids) {
+        const VertexId neighbor = by_target ? edges[edge_id].to : edges[edge_id].from;
+        if (!contracted[neighbor] && neighbor != vertex) {
+            result.push_back(edge_id);
+        }
+    }
+    const auto neighbor = [&edges, by_target](EdgeId edge_id) {
+        return by_target ? edges[edge_id].to : edges[edge_id].from;
+    };
+    std::sort(result.begin(), result.end(), [&edges, &neighbor](EdgeId lhs, EdgeId rhs) {
+        return std::make_pair(neighbor(lhs), edges[lhs].weight) < std::make_pair(neighbor(rhs), edges[rhs].weight);
+    });
+    result.erase(std::unique(result.begin(), result.end(), [&neighbor](EdgeId lhs, EdgeId rhs) {
+        return neighbor(lhs) == neighbor(rhs);
+    }), result.end());
+    return result;
+}
+
+// локальный поиск Дейкстры из source в обход excluded, ограниченный весом и числом вершин
+template <typename Weight>
+void ContractionHierarchy<Weight>::RunWitnessSearch(VertexId source, VertexId excluded, Weight max_weight, Contraction& state) const {
+    auto& workspace = state.witness;
+    workspace.Reset(vertex_count_);
+    workspace.SetLabel(source, ZERO_WEIGHT, NO_EDGE);
+    workspace.Push(ZERO_WEIGHT, source);
+
+    size_t settled = 0;
+    while (!workspace.IsHeapEmpty() && settled < state.witness_settle_limit) {
+        const auto [weight, vertex] = workspace.Pop();
+        if (workspace.GetWeight(vertex) < weight) {
+            continue;
+        }
+        if (max_weight < weight) {
+            break;
+        }
+        ++settled;
+        for (const EdgeId edge_id : state.out_edges[vertex]) {
+            const auto& edge = edges_[edge_id];
+            if (edge.to == excluded || state.contracted[edge.to]) {
+                continue;
+            }
+            const Weight candidate_weight = weight + edge.weight;
+            if (!workspace.IsReached(edge.to) || candidate_weight < workspace.GetWeight(edge.to)) {
+                workspace.SetLabel(edge.to, candidate_weight, edge_id);
+                workspace.Push(candidate_weight, edge.to);
+            }
+        }
+    }
+}
+
+// сжимает вершину (или только считает нужные сокращения при simulate)
+template <typename Weight>
+size_t ContractionHierarchy<Weight>::ContractVertex(VertexId vertex, Contraction& state, bool simulate) {
+    const auto in_edges = GetMinimalEdges(state.in_edges[vertex], edges_, state.contracted, vertex, false);
+    const auto out_edges = GetMinimalEdges(state.out_edges[vertex], edges_, state.contracted, vertex, true);
+    if (in_edges.empty() || out_edges.empty()) {
+        return 0;
+    }
+
+    Weight max_out_weight = ZERO_WEIGHT;
+    for (const EdgeId out_edge : out_edges) {
+        max_out_weight = std::max(max_out_weight, edges_[out_edge].weight);
+    }
+
+    size_t shortcut_count = 0;
+    for (const EdgeId in_edge : in_edges) {
+        const VertexId source = edges_[in_edge].from;
+        const Weight in_weight = edges_[in_edge].weight;
+        RunWitnessSearch(source, vertex, in_weight + max_out_weight, state);
+
+        for (const EdgeId out_edge : out_edges) {
+            const VertexId target = edges_[out_edge].to;
+            if (target == source) {
+                continue;
+            }
+            const Weight shortcut_weight = in_weight + edges_[out_edge].weight;
+            if (state.witness.IsReached(target) && !(shortcut_weight < state.witness.GetWeight(target))) {
+                continue;
+            }
+            ++shortcut_count;
+            if (!simulate) {
+                edges_.push_back({source, target, shortcut_weight, in_edge, out_edge});
+                state.out_edges[source].push_back(edges_.size() - 1);
+                state.in_edges[target].push_back(edges_.size() - 1);
+            }
+        }
+    }
+    return shortcut_count;
+}
+
+// рёбра вверх по рангу для прямого поиска и развёрнутые рёбра вниз для обратного
+template <typename Weight>
+void ContractionHierarchy<Weight>::BuildSearchGraphs() {
+    upward_.offsets.assign(vertex_count_ + 1, 0);
+    downward_.offsets.assign(vertex_count_ + 1, 0);
+    for (const auto& edge : edges_) {
+        if (ranks_[edge.from] < ranks_[edge.to]) {
+            ++upward_.offsets[edge.from + 1];
+        } else {
+            ++downward_.offsets[edge.to + 1];
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        upward_.offsets[vertex + 1] += upward_.offsets[vertex];
+        downward_.offsets[vertex + 1] += downward_.offsets[vertex];
+    }
+
+    upward_.edges.resize(upward_.offsets.back());
+    downward_.edges.resize(downward_.offsets.back());
+    std::vector<size_t> upward_fill(upward_.offsets.begin(), upward_.offsets.end() - 1);
+    std::vector<size_t> downward_fill(downward_.offsets.begin(), downward_.offsets.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        const auto& edge = edges_[edge_id];
+        if (ranks_[edge.from] < ranks_[edge.to]) {
+            upward_.edges[upward_fill[edge.from]++] = edge_id;
+        } else {
+            downward_.edges[downward_fill[edge.to]++] = edge_id;
+        }
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::UnpackEdge(EdgeId edge_id, std::vector<EdgeId>& result) const {
+    std::vector<EdgeId> stack{edge_id};
+    while (!stack.empty()) {
+        const auto& edge = edges_[stack.back()];
+        stack.pop_back();
+        if (edge.second == NO_EDGE) {
+            result.push_back(edge.first);
+        } else {
+            stack.push_back(edge.second);
+            stack.push_back(edge.first);
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchy<Weight>::RouteInfo> ContractionHierarchy<Weight>::BuildRoute(
+    VertexId from, VertexId to, Workspace& workspace) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    auto& forward = workspace.forward;
+    auto& backward = workspace.backward;
+    forward.Reset(vertex_count_);
+    backward.Reset(vertex_count_);
+    forward.SetLabel(from, ZERO_WEIGHT, NO_EDGE);
+    forward.Push(ZERO_WEIGHT, from);
+    backward.SetLabel(to, ZERO_WEIGHT, NO_EDGE);
+    backward.Push(ZERO_WEIGHT, to);
+
+    std::optional<Weight> best_weight;
+    VertexId meeting_vertex = from;
+    bool is_forward = true;
+    while (!forward.IsHeapEmpty() || !backward.IsHeapEmpty()) {
+        if (forward.IsHeapEmpty()) {
+            is_forward = false;
+        } else if (backward.IsHeapEmpty()) {
+            is_forward = true;
+        }
+        auto& search = is_forward ? forward : backward;
+        const auto& opposite = is_forward ? backward : forward;
+        const SearchGraph& search_graph = is_forward ? upward_ : downward_;
+
+        const auto [weight, vertex] = search.Pop();
+        if (search.GetWeight(vertex) < weight) {
+            is_forward = !is_forward;
+            continue;
+        }
+        if (best_weight && !(weight < *best_weight)) {
+            // дальнейший поиск в этом направлении не улучшит ответ
+            while (!search.IsHeapEmpty()) {
+                search.Pop();
+            }
+            is_forward = !is_forward;
+            continue;
+        }
+        search.MarkSettled();
+        if (opposite.IsReached(vertex)) {
+            const Weight candidate_weight = weight + opposite.GetWeight(vertex);
+            if (!best_weight || candidate_weight < *best_weight) {
+                best_weight = candidate_weight;
+                meeting_vertex = vertex;
+            }
+        }
+        for (size_t i = search_graph.offsets[vertex]; i < search_graph.offsets[vertex + 1]; ++i) {
+            const EdgeId edge_id = search_graph.edges[i];
+            const auto& edge = edges_[edge_id];
+            const VertexId next = is_forward ? edge.to : edge.from;
+            const Weight candidate_weight = weight + edge.weight;
+            if (!search.IsReached(next) || candidate_weight < search.GetWeight(next)) {
+                search.SetLabel(next, candidate_weight, edge_id);
+                search.Push(candidate_weight, next);
+            }
+        }
+        is_forward = !is_forward;
+    }
+
+    std::optional<RouteInfo> result;
+    if (best_weight) {
+        std::vector<EdgeId> hierarchy_path;
+        for (EdgeId edge_id = forward.GetPrevEdge(meeting_vertex); edge_id != NO_EDGE;
+             edge_id = forward.GetPrevEdge(edges_[edge_id].from)) {
+            hierarchy_path.push_back(edge_id);
+        }
+        std::reverse(hierarchy_path.begin(), hierarchy_path.end());
+        for (EdgeId edge_id = backward.GetPrevEdge(meeting_vertex); edge_id != NO_EDGE;
+             edge_id = backward.GetPrevEdge(edges_[edge_id].to)) {
+            hierarchy_path.push_back(edge_id);
+        }
+
+        std::vector<EdgeId> edges;
+        for (const EdgeId edge_id : hierarchy_path) {
+            UnpackEdge(edge_id, edges);
+        }
+        result = RouteInfo{*best_weight, std::move(edges)};
+    }
+    return result;
+}
+
+}  // namespace graph
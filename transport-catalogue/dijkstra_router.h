@@ -0,0 +1,209 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Поиск кратчайшего пути алгоритмом Дейкстры на каждый запрос.
+// В отличие от Router не хранит таблицу V x V: память пропорциональна числу рёбер,
+// а перебор исходящих дуг идёт по непрерывным массивам CompressedGraph
+template <typename Weight>
+class DijkstraRouter {
+private:
+    using Graph = CompressedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+
+    // Буферы поиска, переиспользуемые между запросами.
+    // Сброс между запросами выполняется сменой поколения, а не очисткой массивов
+    class Workspace {
+    public:
+        void Reset(size_t vertex_count) {
+            if (marks_.size() != vertex_count) {
+                weights_.assign(vertex_count, ZERO_WEIGHT);
+                prev_edges_.assign(vertex_count, NO_EDGE);
+                marks_.assign(vertex_count, 0);
+                generation_ = 0;
+            }
+            if (++generation_ == 0) {
+                std::fill(marks_.begin(), marks_.end(), 0);
+                generation_ = 1;
+            }
+            heap_.clear();
+            settled_count_ = 0;
+        }
+
+        bool IsReached(VertexId vertex) const {
+            return marks_[vertex] == generation_;
+        }
+
+        Weight GetWeight(VertexId vertex) const {
+            return weights_[vertex];
+        }
+
+        EdgeId GetPrevEdge(VertexId vertex) const {
+            return prev_edges_[vertex];
+        }
+
+        void SetLabel(VertexId vertex, Weight weight, EdgeId prev_edge) {
+            marks_[vertex] = generation_;
+            weights_[vertex] = weight;
+            prev_edges_[vertex] = prev_edge;
+        }
+
+        void Push(Weight weight, VertexId vertex) {
+            heap_.emplace_back(weight, vertex);
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+        }
+
+        std::pair<Weight, VertexId> Pop() {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            const auto top = heap_.back();
+            heap_.pop_back();
+            return top;
+        }
+
+        bool IsHeapEmpty() const {
+            return heap_.empty();
+        }
+
+        void MarkSettled() {
+            ++settled_count_;
+        }
+
+        // число извлечённых из кучи (окончательно обработанных) вершин в последнем поиске
+        size_t GetSettledCount() const {
+            return settled_count_;
+        }
+
+    private:
+        std::vector<Weight> weights_;
+        std::vector<EdgeId> prev_edges_;
+        std::vector<uint32_t> marks_;
+        uint32_t generation_ = 0;
+        std::vector<std::pair<Weight, VertexId>> heap_;
+        size_t settled_count_ = 0;
+    };
+
+    explicit DijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, Workspace& workspace) const {
+        return BuildRoute(from, to, workspace, [](VertexId) {
+            return ZERO_WEIGHT;
+        });
+    }
+
+    // Поиск A*: heuristic(v) - нижняя оценка веса пути от v до to, согласованная с весами рёбер.
+    // Куча упорядочена по весу пути плюс оценке, поэтому вершины далеко от цели не извлекаются
+    template <typename Heuristic>
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, Workspace& workspace, Heuristic heuristic) const;
+
+    // Дерево кратчайших путей из from: после поиска workspace хранит веса и последние рёбра
+    // путей до всех достижимых вершин. При заданном max_weight поиск останавливается на этом весе,
+    // и окончательными остаются только вершины с весом не больше max_weight
+    void BuildTree(VertexId from, Workspace& workspace, std::optional<Weight> max_weight = std::nullopt) const;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr EdgeId NO_EDGE = static_cast<EdgeId>(-1);
+    static constexpr VertexId NO_VERTEX = static_cast<VertexId>(-1);
+
+    const Graph& graph_;
+
+    template <typename Heuristic>
+    void Search(VertexId from, VertexId to, Workspace& workspace, Heuristic heuristic, std::optional<Weight> max_weight) const;
+};
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    const size_t arc_count = graph.GetArcCount();
+    for (size_t arc = 0; arc < arc_count; ++arc) {
+        if (graph.GetArcWeight(arc) < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+template <typename Heuristic>
+void DijkstraRouter<Weight>::Search(VertexId from, VertexId to, Workspace& workspace, Heuristic heuristic,
+                                    std::optional<Weight> max_weight) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    workspace.Reset(vertex_count);
+    workspace.SetLabel(from, ZERO_WEIGHT, NO_EDGE);
+    workspace.Push(heuristic(from), from);
+
+    while (!workspace.IsHeapEmpty()) {
+        const auto [key, vertex] = workspace.Pop();
+        const Weight weight = workspace.GetWeight(vertex);
+        // устаревшая запись кучи: вершина уже извлечена с меньшим весом
+        if (weight + heuristic(vertex) < key) {
+            continue;
+        }
+        if (max_weight && *max_weight < key) {
+            break;
+        }
+        workspace.MarkSettled();
+        if (vertex == to) {
+            break;
+        }
+        const size_t arcs_end = graph_.GetArcsEnd(vertex);
+        for (size_t arc = graph_.GetArcsBegin(vertex); arc < arcs_end; ++arc) {
+            const VertexId target = graph_.GetArcTarget(arc);
+            const Weight candidate_weight = weight + graph_.GetArcWeight(arc);
+            if (!workspace.IsReached(target) || candidate_weight < workspace.GetWeight(target)) {
+                workspace.SetLabel(target, candidate_weight, graph_.GetArcEdge(arc));
+                workspace.Push(candidate_weight + heuristic(target), target);
+            }
+        }
+    }
+}
+
+template <typename Weight>
+void DijkstraRouter<Weight>::BuildTree(VertexId from, Workspace& workspace, std::optional<Weight> max_weight) const {
+    if (from >= graph_.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    Search(from, NO_VERTEX, workspace, [](VertexId) {
+        return ZERO_WEIGHT;
+    }, max_weight);
+}
+
+template <typename Weight>
+template <typename Heuristic>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(
+    VertexId from, VertexId to, Workspace& workspace, Heuristic heuristic) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    Search(from, to, workspace, heuristic, std::nullopt);
+    if (!workspace.IsReached(to)) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = workspace.GetPrevEdge(to);
+         edge_id != NO_EDGE;
+         edge_id = workspace.GetPrevEdge(graph_.GetEdgeSource(edge_id)))
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{workspace.GetWeight(to), std::move(edges)};
+}
+
+}  // namespace graph
@@ -0,0 +1,77 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace catalogue {
+
+namespace {
+
+//перемешивание splitmix64: соседние ключи попадают в далёкие ячейки
+uint64_t MixKey(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ull;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+    return key ^ (key >> 31);
+}
+
+} // namespace
+
+uint64_t DistanceTable::MakeKey(uint32_t from, uint32_t to) {
+    return (static_cast<uint64_t>(std::min(from, to)) << 32) | std::max(from, to);
+}
+
+//ячейка с ключом key или пустая ячейка, в которую его можно вставить
+size_t DistanceTable::FindCell(uint64_t key) const {
+    const size_t mask = cells_.size() - 1;
+    size_t index = MixKey(key) & mask;
+    while (cells_[index].key != key && cells_[index].key != EMPTY_KEY) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void DistanceTable::Grow() {
+    std::vector<Cell> old_cells = std::move(cells_);
+    cells_.assign(std::max<size_t>(old_cells.size() * 2, 16), Cell{});
+    for (const Cell& cell : old_cells) {
+        if (cell.key != EMPTY_KEY) {
+            cells_[FindCell(cell.key)] = cell;
+        }
+    }
+}
+
+void DistanceTable::Set(uint32_t from, uint32_t to, int distance) {
+    const uint64_t key = MakeKey(from, to);
+    if (key == EMPTY_KEY) {
+        throw std::out_of_range("Stop id is out of range");
+    }
+    //заполненность таблицы не больше половины, чтобы цепочки пробирования оставались короткими
+    if ((size_ + 1) * 2 > cells_.size()) {
+        Grow();
+    }
+    Cell& cell = cells_[FindCell(key)];
+    if (cell.key == EMPTY_KEY) {
+        cell.key = key;
+        ++size_;
+    }
+    (from <= to ? cell.forward : cell.backward) = distance;
+}
+
+int DistanceTable::Get(uint32_t from, uint32_t to) const {
+    if (cells_.empty()) {
+        return 0;
+    }
+    const Cell& cell = cells_[FindCell(MakeKey(from, to))];
+    if (cell.key == EMPTY_KEY) {
+        return 0;
+    }
+    const int direct = from <= to ? cell.forward : cell.backward;
+    if (direct != NO_DISTANCE) {
+        return direct;
+    }
+    const int reverse = from <= to ? cell.backward : cell.forward;
+    return reverse != NO_DISTANCE ? reverse : 0;
+}
+
+} // namespace catalogue
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace catalogue {
+
+// Таблица дорожных расстояний между остановками с открытой адресацией.
+// Ключ - пара номеров остановок (меньший, больший), упакованная в 64 бита,
+// поэтому оба направления хранятся в одной ячейке и находятся за один поиск.
+// Ячейки лежат в одном массиве, коллизии разрешаются линейным пробированием
+class DistanceTable {
+public:
+    // задаёт расстояние от остановки from до остановки to
+    void Set(uint32_t from, uint32_t to, int distance);
+
+    // расстояние от from до to; если оно не задано - расстояние в обратную сторону, иначе 0
+    int Get(uint32_t from, uint32_t to) const;
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+    static constexpr int NO_DISTANCE = std::numeric_limits<int>::min();
+
+    struct Cell {
+        uint64_t key = EMPTY_KEY;
+        // расстояние от меньшего номера к большему и обратно
+        int forward = NO_DISTANCE;
+        int backward = NO_DISTANCE;
+    };
+
+    static uint64_t MakeKey(uint32_t from, uint32_t to);
+    size_t FindCell(uint64_t key) const;
+    void Grow();
+
+    std::vector<Cell> cells_;
+    size_t size_ = 0;
+};
+
+} // namespace catalogue
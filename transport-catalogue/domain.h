@@ -1,20 +1,40 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 #include "geo.h"
+#include "ranges.h"
 
 namespace catalogue {
-struct Stop {
-    std::string name;
-    geo::Coordinates coordinates;
+//номер остановки в справочнике, совпадает со Stop::id
+using StopId = uint32_t;
+
+//данные остановок по столбцам, индекс - номер остановки; для проходов,
+//которым нужны только названия или координаты
+struct StopColumns {
+    //названия хранятся в StringInterner справочника
+    std::vector<std::string_view> names;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    //синус и косинус широты, посчитанные при добавлении остановки
+    std::vector<double> sin_latitudes;
+    std::vector<double> cos_latitudes;
 };
 
-struct Bus {
-    std::string number;
-    std::vector<const Stop*> route;
-    bool is_circle;
+//остановка - номер в столбцах справочника, сами данные хранятся только в StopColumns
+struct Stop {
+    const StopColumns* columns = nullptr;
+    //номер остановки в порядке добавления в справочник (от 0 до числа остановок)
+    size_t id = 0;
+
+    std::string_view GetName() const {
+        return columns->names[id];
+    }
+    geo::Coordinates GetCoordinates() const {
+        return {columns->latitudes[id], columns->longitudes[id]};
+    }
 };
 
 struct BusInfo {
@@ -22,5 +42,24 @@ struct BusInfo {
     int unique_stops_count;
     double geo_length;
     int dist_length;
+    //отношение длины по дорогам к географической длине
+    double curvature;
+};
+
+struct Bus {
+    //номер хранится в StringInterner справочника
+    std::string_view number;
+    //остановки маршрута - отрезок общего массива номеров остановок справочника,
+    //см. TransportCatalogue::GetRoute
+    size_t route_offset = 0;
+    size_t route_size = 0;
+    bool is_circle;
+    //статистика маршрута, вычисляется в TransportCatalogue::Finalize
+    BusInfo info{};
 };
+//маршруты и остановки, упорядоченные по названию
+using BusRange = ranges::Range<std::vector<const Bus*>::const_iterator>;
+using StopRange = ranges::Range<std::vector<const Stop*>::const_iterator>;
+//номера остановок маршрута
+using RouteRange = ranges::Range<std::vector<StopId>::const_iterator>;
 } // namespace catalogue    
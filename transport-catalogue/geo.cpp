@@ -5,12 +5,73 @@
 
 namespace geo {
 
+namespace {
+
+const double dr = M_PI / 180.0;
+const double earth_radius = 6371000;
+
+//разность долгот в пределах [-180, 180]
+double GetLongitudeDelta(double from_lng, double to_lng) {
+    double delta = to_lng - from_lng;
+    if (delta > 180.0) {
+        delta -= 360.0;
+    } else if (delta < -180.0) {
+        delta += 360.0;
+    }
+    return delta;
+}
+
+} // namespace
+
+PreparedPoint PreparePoint(Coordinates point) {
+    using namespace std;
+    return {point.lng, sin(point.lat * dr), cos(point.lat * dr)};
+}
+
 double ComputeDistance(Coordinates from, Coordinates to) {
+    return ComputeDistance(PreparePoint(from), PreparePoint(to));
+}
+
+double ComputeDistance(const PreparedPoint& from, const PreparedPoint& to) {
     using namespace std;
-    const double dr = M_PI / 180.0;
-    return acos(sin(from.lat * dr) * sin(to.lat * dr)
-                + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
+    return acos(from.sin_lat * to.sin_lat
+                + from.cos_lat * to.cos_lat * cos(abs(from.lng - to.lng) * dr))
         * 6371000;
 }
 
+void ComputeDistances(const PreparedPoint* points, size_t count, double* lengths) {
+    using namespace std;
+    if (count < 2) {
+        return;
+    }
+    //сначала косинусы центральных углов по всем отрезкам, затем arccos:
+    //в каждом цикле одна операция, и независимые итерации не ждут друг друга
+    for (size_t i = 0; i + 1 < count; ++i) {
+        const PreparedPoint& from = points[i];
+        const PreparedPoint& to = points[i + 1];
+        lengths[i] = from.sin_lat * to.sin_lat + from.cos_lat * to.cos_lat * cos(abs(from.lng - to.lng) * dr);
+    }
+    for (size_t i = 0; i + 1 < count; ++i) {
+        lengths[i] = acos(lengths[i]) * 6371000;
+    }
+}
+
+double ComputeEquirectangularDistance(Coordinates from, Coordinates to) {
+    using namespace std;
+    const double x = GetLongitudeDelta(from.lng, to.lng) * cos((from.lat + to.lat) / 2 * dr);
+    const double y = to.lat - from.lat;
+    return sqrt(x * x + y * y) * dr * earth_radius;
+}
+
+FlatEarthProjection::FlatEarthProjection(double reference_lat)
+    : lat_scale_(dr * earth_radius)
+    , lng_scale_(std::cos(reference_lat * dr) * dr * earth_radius) {
+}
+
+double FlatEarthProjection::ComputeDistance(Coordinates from, Coordinates to) const {
+    const double x = GetLongitudeDelta(from.lng, to.lng) * lng_scale_;
+    const double y = (to.lat - from.lat) * lat_scale_;
+    return std::sqrt(x * x + y * y);
+}
+
 }  // namespace geo
@@ -1,12 +1,61 @@
-#pragma once
-
-namespace geo {
-
-struct Coordinates {
-    double lat; // Широта
-    double lng; // Долгота
-};
-
-double ComputeDistance(Coordinates from, Coordinates to);
-
-}  // namespace geo
+#pragma once
+
+#include <cstddef>
+
+namespace geo {
+
+struct Coordinates {
+    double lat; // Широта
+    double lng; // Долгота
+};
+
+// Точка с заранее вычисленными синусом и косинусом широты.
+// Расстояние между подготовленными точками совпадает с ComputeDistance бит в бит,
+// но на отрезок остаются только cos разности долгот и acos
+struct PreparedPoint {
+    double lng;
+    double sin_lat;
+    double cos_lat;
+};
+
+PreparedPoint PreparePoint(Coordinates point);
+
+double ComputeDistance(Coordinates from, Coordinates to);
+double ComputeDistance(const PreparedPoint& from, const PreparedPoint& to);
+
+// Длины отрезков ломаной из count точек: lengths[i] - расстояние от points[i] до points[i + 1]
+void ComputeDistances(const PreparedPoint* points, size_t count, double* lengths);
+
+// Модель расстояния между точками. GREAT_CIRCLE - точное расстояние ComputeDistance,
+// остальные - приближения без acos для коротких отрезков внутри одного города.
+// Погрешности ниже указаны относительно точного расстояния по большому кругу на той же сфере
+// и проверяются в tests/geo_test.cpp. У самой ComputeDistance на отрезках короче 100 м
+// погрешность acos больше 1e-5, поэтому на таких отрезках приближения с ней расходятся сильнее
+enum class DistanceModel {
+    GREAT_CIRCLE,
+    EQUIRECTANGULAR,
+    FLAT_EARTH
+};
+
+// Равнопромежуточное приближение: разность долгот масштабируется косинусом средней широты отрезка,
+// расстояние берётся как гипотенуза. Один cos и sqrt на отрезок.
+// Относительная погрешность при |lat| <= 70°: не больше 1e-6 для отрезков в пределах 10 км,
+// 3e-5 - в пределах 50 км, 1e-4 - в пределах 100 км; растёт с длиной отрезка квадратично
+double ComputeEquirectangularDistance(Coordinates from, Coordinates to);
+
+// Плоская проекция окрестности широты reference_lat: масштабы градуса широты и долготы
+// вычисляются один раз, на отрезок остаются только умножения и sqrt.
+// Погрешность определяется удалённостью точек от опорной широты: при |lat| <= 70°
+// относительная погрешность не больше 0.5% для точек в пределах 10 км от неё и 2.5% - в пределах 50 км
+class FlatEarthProjection {
+public:
+    explicit FlatEarthProjection(double reference_lat = 0.0);
+
+    double ComputeDistance(Coordinates from, Coordinates to) const;
+
+private:
+    double lat_scale_;
+    double lng_scale_;
+};
+
+}  // namespace geo
@@ -3,6 +3,7 @@
 #include "ranges.h"
 
 #include <cstdlib>
+#include <string_view>
 #include <vector>
 
 namespace graph {
@@ -12,7 +13,8 @@ using EdgeId = size_t;
 
 template <typename Weight>
 struct Edge {
-    std::string name;
+    //название остановки или маршрута; строку хранит владелец графа
+    std::string_view name;
     size_t quality;
     VertexId from;
     VertexId to;
@@ -73,4 +75,102 @@ typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+// Замороженный граф в формате CSR (compressed sparse row).
+// Исходящие дуги вершины лежат в непрерывных массивах целей и весов,
+// а имена и число пролётов остаются в таблице рёбер исходного графа (по EdgeId)
+template <typename Weight>
+class CompressedGraph {
+public:
+    CompressedGraph() = default;
+    explicit CompressedGraph(const DirectedWeightedGraph<Weight>& graph);
+
+    size_t GetVertexCount() const;
+    size_t GetEdgeCount() const;
+    size_t GetArcCount() const;
+
+    // дуги вершины занимают индексы [GetArcsBegin(v), GetArcsEnd(v))
+    size_t GetArcsBegin(VertexId vertex) const;
+    size_t GetArcsEnd(VertexId vertex) const;
+    VertexId GetArcTarget(size_t arc) const;
+    Weight GetArcWeight(size_t arc) const;
+    EdgeId GetArcEdge(size_t arc) const;
+
+    VertexId GetEdgeSource(EdgeId edge_id) const;
+
+private:
+    std::vector<size_t> offsets_;
+    std::vector<VertexId> targets_;
+    std::vector<Weight> weights_;
+    std::vector<EdgeId> arc_edges_;
+    std::vector<VertexId> edge_sources_;
+};
+
+template <typename Weight>
+CompressedGraph<Weight>::CompressedGraph(const DirectedWeightedGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    const size_t edge_count = graph.GetEdgeCount();
+    offsets_.reserve(vertex_count + 1);
+    targets_.reserve(edge_count);
+    weights_.reserve(edge_count);
+    arc_edges_.reserve(edge_count);
+    edge_sources_.resize(edge_count);
+
+    offsets_.push_back(0);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto& edge = graph.GetEdge(edge_id);
+            targets_.push_back(edge.to);
+            weights_.push_back(edge.weight);
+            arc_edges_.push_back(edge_id);
+            edge_sources_[edge_id] = edge.from;
+        }
+        offsets_.push_back(targets_.size());
+    }
+}
+
+template <typename Weight>
+size_t CompressedGraph<Weight>::GetVertexCount() const {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+}
+
+template <typename Weight>
+size_t CompressedGraph<Weight>::GetEdgeCount() const {
+    return edge_sources_.size();
+}
+
+template <typename Weight>
+size_t CompressedGraph<Weight>::GetArcCount() const {
+    return targets_.size();
+}
+
+template <typename Weight>
+size_t CompressedGraph<Weight>::GetArcsBegin(VertexId vertex) const {
+    return offsets_[vertex];
+}
+
+template <typename Weight>
+size_t CompressedGraph<Weight>::GetArcsEnd(VertexId vertex) const {
+    return offsets_[vertex + 1];
+}
+
+template <typename Weight>
+VertexId CompressedGraph<Weight>::GetArcTarget(size_t arc) const {
+    return targets_[arc];
+}
+
+template <typename Weight>
+Weight CompressedGraph<Weight>::GetArcWeight(size_t arc) const {
+    return weights_[arc];
+}
+
+template <typename Weight>
+EdgeId CompressedGraph<Weight>::GetArcEdge(size_t arc) const {
+    return arc_edges_[arc];
+}
+
+template <typename Weight>
+VertexId CompressedGraph<Weight>::GetEdgeSource(EdgeId edge_id) const {
+    return edge_sources_[edge_id];
+}
 }  // namespace graph
@@ -1,8 +1,24 @@
 #include "json_reader.h"
 #include "json_builder.h"
 
+#include <cmath>
+#include <cstdint>
+
 namespace reader {
 
+namespace {
+
+//отпечаток FNV-1a строки
+uint64_t HashString(std::string_view str, uint64_t hash = 14695981039346656037ull) {
+    for (const char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
 const json::Node& JsonReader::GetBaseRequests() const {
     auto it = input_.GetRoot().AsDict().find("base_requests");
     if (it == input_.GetRoot().AsDict().end()) {
@@ -65,10 +81,7 @@ void JsonReader::ParseBaseRequests() {
 void JsonReader::ApplyCommands([[maybe_unused]]catalogue::TransportCatalogue& catalogue) const {
     for (const auto& cd : commands_) {
         if (cd.command == "Stop") {
-            catalogue::Stop stop;
-            stop.name = cd.id;
-            stop.coordinates = std::get<geo::Coordinates>(cd.description);
-            catalogue.AddStop(stop);
+            catalogue.AddStop(cd.id, std::get<geo::Coordinates>(cd.description));
         }
     }
     for (const auto& cd : commands_) {
@@ -83,17 +96,16 @@ void JsonReader::ApplyCommands([[maybe_unused]]catalogue::TransportCatalogue& ca
     }
     for (const auto& cd : commands_) {    
         if (cd.command == "Bus") {
-            catalogue::Bus bus;
-            bus.number = cd.id;
-            std::vector<std::string_view> route = std::get<std::vector<std::string_view>>(cd.description);
+            std::vector<const catalogue::Stop*> stops;
+            const std::vector<std::string_view>& route = std::get<std::vector<std::string_view>>(cd.description);
             for (const auto& stop : route) {
-                const catalogue::Stop* stop_ptr = catalogue.FindStop(stop);
-                bus.route.push_back(stop_ptr);
+                stops.push_back(catalogue.FindStop(stop));
             }
-            bus.is_circle = std::get<bool>(cd.details);
-            catalogue.AddBus(bus);
+            catalogue.AddBus(cd.id, stops, std::get<bool>(cd.details));
         }
     }
+    catalogue.SetDistanceModel(GetDistanceModel());
+    catalogue.Finalize();
 }
     
 svg::Color JsonReader::ParseColor(const json::Node& color_node) const {
@@ -143,7 +155,8 @@ const json::Node JsonReader::PrintRoute(const json::Dict& request_map, RequestHa
     json::Node result;
     const std::string& route_number = request_map.at("name").AsString();
     const int id = request_map.at("id").AsInt();
-    if (!rh.IsBusNumber(route_number)) {
+    const catalogue::BusInfo* bus_info = rh.GetBusStat(route_number);
+    if (!bus_info) {
         result = json::Builder{}
                     .StartDict()
                         .Key("request_id").Value(id)
@@ -154,10 +167,10 @@ const json::Node JsonReader::PrintRoute(const json::Dict& request_map, RequestHa
         result = json::Builder{}
                     .StartDict()
                         .Key("request_id").Value(id)
-                        .Key("curvature").Value(rh.GetBusStat(route_number).dist_length/rh.GetBusStat(route_number).geo_length)
-                        .Key("route_length").Value(rh.GetBusStat(route_number).dist_length)
-                        .Key("stop_count").Value(static_cast<int>(rh.GetBusStat(route_number).stops_count))
-                        .Key("unique_stop_count").Value(static_cast<int>(rh.GetBusStat(route_number).unique_stops_count))
+                        .Key("curvature").Value(bus_info->curvature)
+                        .Key("route_length").Value(bus_info->dist_length)
+                        .Key("stop_count").Value(bus_info->stops_count)
+                        .Key("unique_stop_count").Value(bus_info->unique_stops_count)
                     .EndDict()
                 .Build();
     }
@@ -193,37 +206,122 @@ const json::Node JsonReader::PrintStop(const json::Dict& request_map, RequestHan
 const json::Node JsonReader::PrintMap(const json::Dict& request_map, RequestHandler& rh) const {
     json::Node result;
     const int id = request_map.at("id").AsInt();
-    std::ostringstream strm;
-    svg::Document map = rh.RenderMap();
-    map.Render(strm);
     result = json::Builder{}
                 .StartDict()
                     .Key("request_id").Value(id)
-                    .Key("map").Value(strm.str())
+                    .Key("map").Value(rh.RenderMapText())
                 .EndDict()
             .Build();
     return result;    
 }
     
+std::optional<json::Node> JsonReader::ProcessRequest(const json::Dict& request_map, RequestHandler& rh) const {
+    const auto& type = request_map.at("type").AsString();
+    if (type == "Stop") {
+        return PrintStop(request_map, rh);
+    }
+    if (type == "Bus") {
+        return PrintRoute(request_map, rh);
+    }
+    if (type == "Map") {
+        return PrintMap(request_map, rh);
+    }
+    if (type == "Route") {
+        return PrintRouting(request_map, rh);
+    }
+    if (type == "Matrix") {
+        return PrintMatrix(request_map, rh);
+    }
+    if (type == "Isochrone") {
+        return PrintIsochrone(request_map, rh);
+    }
+    if (type == "RoutingStats") {
+        return PrintRoutingStats(request_map, rh);
+    }
+    return std::nullopt;
+}
+
+geo::DistanceModel JsonReader::GetDistanceModel() const {
+    auto it = input_.GetRoot().AsDict().find("catalogue_settings");
+    if (it == input_.GetRoot().AsDict().end()) {
+        return geo::DistanceModel::GREAT_CIRCLE;
+    }
+    const auto model_it = it->second.AsDict().find("distance_model");
+    if (model_it == it->second.AsDict().end()) {
+        return geo::DistanceModel::GREAT_CIRCLE;
+    }
+    const std::string& model = model_it->second.AsString();
+    if (model == "great_circle") {
+        return geo::DistanceModel::GREAT_CIRCLE;
+    } else if (model == "equirectangular") {
+        return geo::DistanceModel::EQUIRECTANGULAR;
+    } else if (model == "flat_earth") {
+        return geo::DistanceModel::FLAT_EARTH;
+    }
+    throw std::logic_error("wrong distance model");
+}
+
+size_t JsonReader::GetRequestThreadCount() const {
+    auto it = input_.GetRoot().AsDict().find("request_processing_settings");
+    if (it == input_.GetRoot().AsDict().end()) {
+        return 1;
+    }
+    const auto threads_it = it->second.AsDict().find("threads");
+    if (threads_it == it->second.AsDict().end()) {
+        return 1;
+    }
+    return static_cast<size_t>(threads_it->second.AsInt());
+}
+
+//Оценки трудоёмкости запросов в условных единицах: по ним планировщик
+//заранее распределяет запросы между потоками, начиная с самых дорогих
+size_t JsonReader::GetRequestCost(const json::Dict& request_map) const {
+    const auto& type = request_map.at("type").AsString();
+    if (type == "Stop") {
+        return 1;
+    }
+    if (type == "Bus") {
+        return 2;
+    }
+    if (type == "Route") {
+        return 20;
+    }
+    if (type == "Isochrone") {
+        return 200;
+    }
+    if (type == "Matrix") {
+        return 20 * std::max<size_t>(request_map.at("from").AsArray().size() * request_map.at("to").AsArray().size(), 1);
+    }
+    if (type == "Map") {
+        return 1000;
+    }
+    return 1;
+}
+
+//Запросы только читают справочник и маршрутизатор, поэтому разбираются
+//потоками планировщика обработчика. Ответ записывается в ячейку с номером запроса,
+//так что порядок ответов совпадает с порядком запросов
 void JsonReader::ProcessRequests(const json::Node& stat_requests, RequestHandler& rh) const {
+    const json::Array& requests = stat_requests.AsArray();
+    std::vector<std::optional<json::Node>> responses(requests.size());
+
+    std::vector<scheduling::TaskScheduler::WeightedTask> tasks;
+    tasks.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const json::Dict& request_map = requests[i].AsDict();
+        tasks.push_back({[this, &request_map, &rh, &response = responses[i]] {
+            response = ProcessRequest(request_map, rh);
+        }, GetRequestCost(request_map)});
+    }
+    rh.RunTasks(std::move(tasks));
+
     json::Array result;
-    for (auto& request : stat_requests.AsArray()) {
-        const auto& request_map = request.AsDict();
-        const auto& type = request_map.at("type").AsString();
-        if (type == "Stop") {
-            result.emplace_back(PrintStop(request_map, rh).AsDict());
-        }
-        if (type == "Bus") {
-            result.emplace_back(PrintRoute(request_map, rh).AsDict());
-        }
-        if (type == "Map") {
-            result.emplace_back(PrintMap(request_map, rh).AsDict());
-        }
-        if (type == "Route") {
-            result.emplace_back(PrintRouting(request_map, rh).AsDict());        
+    result.reserve(responses.size());
+    for (auto& response : responses) {
+        if (response) {
+            result.push_back(std::move(*response));
         }
     }
-
     json::Print(json::Document{ result }, std::cout);
 }
     
@@ -244,6 +342,62 @@ catalogue::TransportRouter::Settings JsonReader::FillRoutingSettings(const json:
     routing_settings.bus_wait_time_ = settings.AsDict().at("bus_wait_time").AsInt(); 
     routing_settings.bus_velocity_ = settings.AsDict().at("bus_velocity").AsDouble();
     
+    const auto mode_it = settings.AsDict().find("routing_mode");
+    if (mode_it != settings.AsDict().end()) {
+        const std::string& mode = mode_it->second.AsString();
+        if (mode == "all_pairs") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::ALL_PAIRS;
+        } else if (mode == "dijkstra") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::DIJKSTRA;
+        } else if (mode == "a_star") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::A_STAR;
+        } else if (mode == "raptor") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::RAPTOR;
+        } else if (mode == "contraction_hierarchies") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::CONTRACTION_HIERARCHIES;
+        } else if (mode == "shortest_path_trees") {
+            routing_settings.routing_mode_ = catalogue::TransportRouter::RoutingMode::SHORTEST_PATH_TREES;
+        } else {
+            throw std::logic_error("wrong routing mode");
+        }
+    }
+    
+    const auto threads_it = settings.AsDict().find("router_threads");
+    if (threads_it != settings.AsDict().end()) {
+        routing_settings.router_threads_ = static_cast<size_t>(threads_it->second.AsInt());
+    }
+    
+    const auto tree_cache_it = settings.AsDict().find("tree_cache_size");
+    if (tree_cache_it != settings.AsDict().end()) {
+        routing_settings.tree_cache_size_ = static_cast<size_t>(tree_cache_it->second.AsInt());
+    }
+    
+    const auto table_weight_it = settings.AsDict().find("router_table_weight");
+    if (table_weight_it != settings.AsDict().end()) {
+        const std::string& table_weight = table_weight_it->second.AsString();
+        if (table_weight == "double") {
+            routing_settings.table_weight_ = catalogue::TransportRouter::TableWeight::DOUBLE;
+        } else if (table_weight == "float") {
+            routing_settings.table_weight_ = catalogue::TransportRouter::TableWeight::FLOAT;
+        } else if (table_weight == "fixed_point") {
+            routing_settings.table_weight_ = catalogue::TransportRouter::TableWeight::FIXED_POINT;
+        } else {
+            throw std::logic_error("wrong router table weight");
+        }
+    }
+    
+    //таблица всех пар сохраняется в файл и при следующем запуске загружается из него,
+    //если не изменились остановки, автобусы, время ожидания и скорость
+    const auto cache_it = input_.GetRoot().AsDict().find("router_cache_settings");
+    if (cache_it != input_.GetRoot().AsDict().end()) {
+        routing_settings.cache_file_ = cache_it->second.AsDict().at("file").AsString();
+        std::ostringstream key_data;
+        json::Print(json::Document{GetBaseRequests()}, key_data);
+        key_data.precision(17);
+        key_data << ' ' << routing_settings.bus_wait_time_ << ' ' << routing_settings.bus_velocity_;
+        routing_settings.cache_key_ = HashString(key_data.str());
+    }
+    
     return routing_settings;
 }
     
@@ -252,9 +406,9 @@ const json::Node JsonReader::PrintRouting(const json::Dict& request_map, Request
     const int id = request_map.at("id").AsInt();
     const std::string_view stop_from = request_map.at("from").AsString();
     const std::string_view stop_to = request_map.at("to").AsString();
-    const auto& routing = rh.GetOptimalRoute(stop_from, stop_to);
+    const auto route_items = rh.GetRouteItems(stop_from, stop_to);
     
-    if (!routing) {
+    if (!route_items) {
         result = json::Builder{}
             .StartDict()
                 .Key("request_id").Value(id)
@@ -265,13 +419,13 @@ const json::Node JsonReader::PrintRouting(const json::Dict& request_map, Request
     else {
         json::Array items;
         double total_time = 0.0;
-        items.reserve(routing.value().edges.size());
-        for (auto& edge_id : routing.value().edges) {
-            const graph::Edge<double> edge = rh.GetRouterGraph(stop_from, stop_to)->GetEdge(edge_id);
+        items.reserve(route_items.GetItemCount());
+        for (size_t i = 0; i < route_items.GetItemCount(); ++i) {
+            const graph::Edge<double>& edge = route_items.GetItem(i);
             if (edge.quality == 0) {
                 items.emplace_back(json::Node(json::Builder{}
                     .StartDict()
-                        .Key("stop_name").Value(edge.name)
+                        .Key("stop_name").Value(std::string(edge.name))
                         .Key("time").Value(edge.weight)
                         .Key("type").Value("Wait")
                     .EndDict()
@@ -282,7 +436,7 @@ const json::Node JsonReader::PrintRouting(const json::Dict& request_map, Request
             else {
                 items.emplace_back(json::Node(json::Builder{}
                     .StartDict()
-                        .Key("bus").Value(edge.name)
+                        .Key("bus").Value(std::string(edge.name))
                         .Key("span_count").Value(static_cast<int>(edge.quality))
                         .Key("time").Value(edge.weight)
                         .Key("type").Value("Bus")
@@ -305,4 +459,95 @@ const json::Node JsonReader::PrintRouting(const json::Dict& request_map, Request
     return result;
 }    
 
+const json::Node JsonReader::PrintMatrix(const json::Dict& request_map, RequestHandler& rh) const {
+    const int id = request_map.at("id").AsInt();
+    std::vector<std::string_view> stops_from;
+    std::vector<std::string_view> stops_to;
+    bool all_stops_found = true;
+    for (const auto& stop : request_map.at("from").AsArray()) {
+        stops_from.push_back(stop.AsString());
+        all_stops_found = all_stops_found && rh.IsStopName(stops_from.back());
+    }
+    for (const auto& stop : request_map.at("to").AsArray()) {
+        stops_to.push_back(stop.AsString());
+        all_stops_found = all_stops_found && rh.IsStopName(stops_to.back());
+    }
+    if (!all_stops_found) {
+        return json::Builder{}
+                    .StartDict()
+                        .Key("request_id").Value(id)
+                        .Key("error_message").Value("not found")
+                    .EndDict()
+                .Build();
+    }
+
+    const auto matrix = rh.GetTravelTimeMatrix(stops_from, stops_to);
+    json::Array times;
+    times.reserve(matrix.row_count);
+    for (size_t row = 0; row < matrix.row_count; ++row) {
+        json::Array row_times;
+        row_times.reserve(matrix.column_count);
+        for (size_t column = 0; column < matrix.column_count; ++column) {
+            const double time = matrix.Get(row, column);
+            row_times.emplace_back(std::isinf(time) ? json::Node(nullptr) : json::Node(time));
+        }
+        times.emplace_back(std::move(row_times));
+    }
+    return json::Builder{}
+                .StartDict()
+                    .Key("request_id").Value(id)
+                    .Key("times").Value(std::move(times))
+                .EndDict()
+            .Build();
+}
+
+const json::Node JsonReader::PrintIsochrone(const json::Dict& request_map, RequestHandler& rh) const {
+    const int id = request_map.at("id").AsInt();
+    const std::string_view stop_from = request_map.at("from").AsString();
+    if (!rh.IsStopName(stop_from)) {
+        return json::Builder{}
+                    .StartDict()
+                        .Key("request_id").Value(id)
+                        .Key("error_message").Value("not found")
+                    .EndDict()
+                .Build();
+    }
+
+    json::Array stops;
+    for (const auto& [stop_name, time] : rh.GetReachableStops(stop_from, request_map.at("max_time").AsDouble())) {
+        stops.emplace_back(json::Dict{
+            {"stop_name", json::Node(std::string(stop_name))},
+            {"time", json::Node(time)}
+        });
+    }
+    return json::Builder{}
+                .StartDict()
+                    .Key("request_id").Value(id)
+                    .Key("stops").Value(std::move(stops))
+                .EndDict()
+            .Build();
+}
+
+const json::Node JsonReader::PrintRoutingStats(const json::Dict& request_map, RequestHandler& rh) const {
+    const int id = request_map.at("id").AsInt();
+    const auto stats = rh.GetRoutingStats();
+    const double average_query_time = stats.query_count == 0
+        ? 0.0
+        : std::chrono::duration<double, std::micro>(stats.query_time).count() / static_cast<double>(stats.query_count);
+    return json::Builder{}
+                .StartDict()
+                    .Key("request_id").Value(id)
+                    .Key("preprocessing_time_ms").Value(std::chrono::duration<double, std::milli>(stats.preprocessing_time).count())
+                    .Key("shortcut_count").Value(static_cast<int>(stats.shortcut_count))
+                    .Key("query_count").Value(static_cast<int>(stats.query_count))
+                    .Key("average_query_time_us").Value(average_query_time)
+                    .Key("settled_vertex_count").Value(static_cast<int>(stats.settled_vertex_count))
+                    .Key("tree_cache_hit_count").Value(static_cast<int>(stats.tree_cache_hit_count))
+                    .Key("tree_cache_miss_count").Value(static_cast<int>(stats.tree_cache_miss_count))
+                    .Key("tree_cache_eviction_count").Value(static_cast<int>(stats.tree_cache_eviction_count))
+                    .Key("tree_cache_memory_bytes").Value(static_cast<int>(stats.tree_cache_memory_bytes))
+                .EndDict()
+            .Build();
+}
+
 } // namespace reader
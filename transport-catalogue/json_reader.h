@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <variant>
 #include <sstream>
 
@@ -54,7 +55,12 @@ public:
     const json::Node& GetRoutingSettings() const;    
     
     void ParseBaseRequests();
+    //модель географических расстояний из catalogue_settings (по умолчанию great_circle)
+    geo::DistanceModel GetDistanceModel() const;
+    //число потоков для ответов на запросы из request_processing_settings (0 - по числу ядер)
+    size_t GetRequestThreadCount() const;
     void ProcessRequests(const json::Node& stat_requests, RequestHandler& rh) const;    
+    std::optional<json::Node> ProcessRequest(const json::Dict& request_map, RequestHandler& rh) const;
     void ApplyCommands(catalogue::TransportCatalogue& catalogue) const;
     svg::Color ParseColor(const json::Node& color_node) const;
     renderer::MapRenderer ParseRenderSettings(const json::Dict& request_map) const;
@@ -64,11 +70,15 @@ public:
     const json::Node PrintStop(const json::Dict& request_map, RequestHandler& rh) const;
     const json::Node PrintMap(const json::Dict& request_map, RequestHandler& rh) const;
     const json::Node PrintRouting(const json::Dict& request_map, RequestHandler& rh) const;    
+    const json::Node PrintMatrix(const json::Dict& request_map, RequestHandler& rh) const;
+    const json::Node PrintIsochrone(const json::Dict& request_map, RequestHandler& rh) const;
+    const json::Node PrintRoutingStats(const json::Dict& request_map, RequestHandler& rh) const;
     
 private:
     json::Document input_;
     json::Node dummy_ = nullptr;
     std::vector<CommandDescription> commands_;
+    size_t GetRequestCost(const json::Dict& request_map) const;
     std::tuple<std::string_view, std::vector<const catalogue::Stop*>, bool> FillRoute(const json::Dict& request_map, catalogue::TransportCatalogue& catalogue) const;    
 };
 } // namespace reader
@@ -19,7 +19,7 @@ int main() {
     const auto& routing_settings = json_doc.FillRoutingSettings(json_doc.GetRoutingSettings());
     const catalogue::TransportRouter router(routing_settings, catalogue);  
 
-    RequestHandler rh(catalogue, renderer, router);
+    RequestHandler rh(catalogue, renderer, router, json_doc.GetRequestThreadCount());
     json_doc.ProcessRequests(stat_requests, rh);    
     return 0;
 }
@@ -6,16 +6,17 @@ bool IsZero(double value) {
     return std::abs(value) < std::numeric_limits<double>::epsilon();
 }
 
-std::vector<svg::Polyline> MapRenderer::GetRouteLines(const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const {
+std::vector<svg::Polyline> MapRenderer::GetRouteLines(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const {
     std::vector<svg::Polyline> result;
     size_t color_num = 0;
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->route.empty()) continue;
-        std::vector<const catalogue::Stop*> route_stops{ bus->route.begin(), bus->route.end() };
-        if (bus->is_circle == false) route_stops.insert(route_stops.end(), std::next(bus->route.rbegin()), bus->route.rend());
+    for (const catalogue::Bus* bus : buses) {
+        const catalogue::RouteRange route = catalogue.GetRoute(*bus);
+        if (route.empty()) continue;
+        std::vector<catalogue::StopId> route_stops{ route.begin(), route.end() };
+        if (bus->is_circle == false) route_stops.insert(route_stops.end(), std::next(std::make_reverse_iterator(route.end())), std::make_reverse_iterator(route.begin()));
         svg::Polyline line;
-        for (const auto& stop : route_stops) {
-            line.AddPoint(sp(stop->coordinates));
+        for (const catalogue::StopId stop : route_stops) {
+            line.AddPoint(sp(catalogue.GetStopCoordinates(stop)));
         }
         line.SetStrokeColor(render_settings_.color_palette[color_num]);
         line.SetFillColor("none");
@@ -32,29 +33,30 @@ std::vector<svg::Polyline> MapRenderer::GetRouteLines(const std::map<std::string
     return result;
 }
     
-std::vector<svg::Text> MapRenderer::GetBusLabel(const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const {
+std::vector<svg::Text> MapRenderer::GetBusLabel(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const {
     std::vector<svg::Text> result;
     size_t color_num = 0;
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->route.empty()) continue;
+    for (const catalogue::Bus* bus : buses) {
+        const catalogue::RouteRange route = catalogue.GetRoute(*bus);
+        if (route.empty()) continue;
         svg::Text text;
         svg::Text underlayer;
-        text.SetPosition(sp(bus->route[0]->coordinates));
+        text.SetPosition(sp(catalogue.GetStopCoordinates(route[0])));
         text.SetOffset(render_settings_.bus_label_offset);
         text.SetFontSize(render_settings_.bus_label_font_size);
         text.SetFontFamily("Verdana");
         text.SetFontWeight("bold");
-        text.SetData(bus->number);
+        text.SetData(std::string(bus->number));
         text.SetFillColor(render_settings_.color_palette[color_num]);
         if (color_num < (render_settings_.color_palette.size() - 1)) ++color_num;
         else color_num = 0;
         
-        underlayer.SetPosition(sp(bus->route[0]->coordinates));
+        underlayer.SetPosition(sp(catalogue.GetStopCoordinates(route[0])));
         underlayer.SetOffset(render_settings_.bus_label_offset);
         underlayer.SetFontSize(render_settings_.bus_label_font_size);
         underlayer.SetFontFamily("Verdana");
         underlayer.SetFontWeight("bold");
-        underlayer.SetData(bus->number);
+        underlayer.SetData(std::string(bus->number));
         underlayer.SetFillColor(render_settings_.underlayer_color);
         underlayer.SetStrokeColor(render_settings_.underlayer_color);
         underlayer.SetStrokeWidth(render_settings_.underlayer_width);
@@ -64,11 +66,11 @@ std::vector<svg::Text> MapRenderer::GetBusLabel(const std::map<std::string_view,
         result.push_back(underlayer);
         result.push_back(text);
         
-        if (bus->is_circle == false && bus->route[0] != bus->route[bus->route.size() - 1]) {
+        if (bus->is_circle == false && route[0] != route[route.size() - 1]) {
             svg::Text text2 {text};
             svg::Text underlayer2 {underlayer};
-            text2.SetPosition(sp(bus->route[bus->route.size() - 1]->coordinates));
-            underlayer2.SetPosition(sp(bus->route[bus->route.size() - 1]->coordinates));
+            text2.SetPosition(sp(catalogue.GetStopCoordinates(route[route.size() - 1])));
+            underlayer2.SetPosition(sp(catalogue.GetStopCoordinates(route[route.size() - 1])));
             
             result.push_back(underlayer2);
             result.push_back(text2);
@@ -78,11 +80,11 @@ std::vector<svg::Text> MapRenderer::GetBusLabel(const std::map<std::string_view,
     return result;
 }
 
-std::vector<svg::Circle> MapRenderer::GetStopsSymbols(const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const {
+std::vector<svg::Circle> MapRenderer::GetStopsSymbols(catalogue::StopRange stops, const SphereProjector& sp) const {
     std::vector<svg::Circle> result;
-    for (const auto& [stop_name, stop] : stops) {
+    for (const catalogue::Stop* stop : stops) {
         svg::Circle symbol;
-        symbol.SetCenter(sp(stop->coordinates));
+        symbol.SetCenter(sp(stop->GetCoordinates()));
         symbol.SetRadius(render_settings_.stop_radius);
         symbol.SetFillColor("white");
         
@@ -92,23 +94,23 @@ std::vector<svg::Circle> MapRenderer::GetStopsSymbols(const std::map<std::string
     return result;
 }
 
-std::vector<svg::Text> MapRenderer::GetStopsLabels(const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const {
+std::vector<svg::Text> MapRenderer::GetStopsLabels(catalogue::StopRange stops, const SphereProjector& sp) const {
     std::vector<svg::Text> result;
     svg::Text text;
     svg::Text underlayer;
-    for (const auto& [stop_name, stop] : stops) {
-        text.SetPosition(sp(stop->coordinates));
+    for (const catalogue::Stop* stop : stops) {
+        text.SetPosition(sp(stop->GetCoordinates()));
         text.SetOffset(render_settings_.stop_label_offset);
         text.SetFontSize(render_settings_.stop_label_font_size);
         text.SetFontFamily("Verdana");
-        text.SetData(stop->name);
+        text.SetData(std::string(stop->GetName()));
         text.SetFillColor("black");
         
-        underlayer.SetPosition(sp(stop->coordinates));
+        underlayer.SetPosition(sp(stop->GetCoordinates()));
         underlayer.SetOffset(render_settings_.stop_label_offset);
         underlayer.SetFontSize(render_settings_.stop_label_font_size);
         underlayer.SetFontFamily("Verdana");
-        underlayer.SetData(stop->name);
+        underlayer.SetData(std::string(stop->GetName()));
         underlayer.SetFillColor(render_settings_.underlayer_color);
         underlayer.SetStrokeColor(render_settings_.underlayer_color);
         underlayer.SetStrokeWidth(render_settings_.underlayer_width);
@@ -122,59 +124,85 @@ std::vector<svg::Text> MapRenderer::GetStopsLabels(const std::map<std::string_vi
     return result;
 }
     
-svg::Document MapRenderer::GetSVG(const std::map<std::string_view, const catalogue::Bus*>& buses) const {
+svg::Document MapRenderer::GetSVG(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses) const {
     svg::Document result;
+    const MapContext context = GetMapContext(catalogue, buses);
+    for (const MapLayer layer : MAP_LAYERS) {
+        AddLayer(result, layer, buses, context);
+    }
+    return result;
+}
+
+MapContext MapRenderer::GetMapContext(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses) const {
     std::vector<geo::Coordinates> route_stops_coord;
-    std::map<std::string_view, const catalogue::Stop*> stops;
+    std::vector<const catalogue::Stop*> stops;
     
     // Сбор координат остановок и их объектов по маршруту автобусов
-    CollectRouteStops(buses, route_stops_coord, stops);
+    CollectRouteStops(catalogue, buses, route_stops_coord, stops);
     
     SphereProjector sp(route_stops_coord.begin(), route_stops_coord.end(), render_settings_.width, render_settings_.height, render_settings_.padding);
-    
-    // Добавление линий маршрутов
-    AddRouteLines(result, buses, sp);
-    // Добавление надписей автобусов
-    AddBusLabels(result, buses, sp);
-    // Добавление символов остановок
-    AddStopsSymbols(result, stops, sp);
-    // Добавление надписей остановок
-    AddStopsLabels(result, stops, sp);
-    
-    return result;
+    return MapContext{&catalogue, std::move(stops), sp};
 }
 
-void MapRenderer::CollectRouteStops(const std::map<std::string_view, const catalogue::Bus*>& buses, std::vector<geo::Coordinates>& route_stops_coord, std::map<std::string_view, const catalogue::Stop*>& stops) const {
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->route.empty()) {
-            continue;
-        }
-        for (const auto& stop : bus->route) {
-            route_stops_coord.push_back(stop->coordinates);
-            stops[stop->name] = stop;
+void MapRenderer::AddLayer(svg::Document& result, MapLayer layer, catalogue::BusRange buses, const MapContext& context) const {
+    switch (layer) {
+        case MapLayer::ROUTE_LINES:
+            // Добавление линий маршрутов
+            AddRouteLines(result, *context.catalogue, buses, context.projector);
+            break;
+        case MapLayer::BUS_LABELS:
+            // Добавление надписей автобусов
+            AddBusLabels(result, *context.catalogue, buses, context.projector);
+            break;
+        case MapLayer::STOP_SYMBOLS:
+            // Добавление символов остановок
+            AddStopsSymbols(result, ranges::AsRange(context.stops), context.projector);
+            break;
+        case MapLayer::STOP_LABELS:
+            // Добавление надписей остановок
+            AddStopsLabels(result, ranges::AsRange(context.stops), context.projector);
+            break;
+    }
+}
+
+void MapRenderer::CollectRouteStops(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, std::vector<geo::Coordinates>& route_stops_coord, std::vector<const catalogue::Stop*>& stops) const {
+    // Координаты и названия читаются из столбцов справочника по номерам остановок
+    std::vector<catalogue::StopId> stop_ids;
+    for (const catalogue::Bus* bus : buses) {
+        for (const catalogue::StopId stop : catalogue.GetRoute(*bus)) {
+            route_stops_coord.push_back(catalogue.GetStopCoordinates(stop));
+            stop_ids.push_back(stop);
         }
     }
+    std::sort(stop_ids.begin(), stop_ids.end(), [&catalogue](catalogue::StopId lhs, catalogue::StopId rhs) {
+        return catalogue.GetStopName(lhs) < catalogue.GetStopName(rhs);
+    });
+    stop_ids.erase(std::unique(stop_ids.begin(), stop_ids.end()), stop_ids.end());
+    stops.reserve(stop_ids.size());
+    for (const catalogue::StopId stop : stop_ids) {
+        stops.push_back(catalogue.GetStop(stop));
+    }
 }
 
-void MapRenderer::AddRouteLines(svg::Document& result, const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const {
-    for (const auto& line : GetRouteLines(buses, sp)) {
+void MapRenderer::AddRouteLines(svg::Document& result, const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const {
+    for (const auto& line : GetRouteLines(catalogue, buses, sp)) {
         result.Add(line);
     }
 }
 
-void MapRenderer::AddBusLabels(svg::Document& result, const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const {
-    for (const auto& text : GetBusLabel(buses, sp)) {
+void MapRenderer::AddBusLabels(svg::Document& result, const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const {
+    for (const auto& text : GetBusLabel(catalogue, buses, sp)) {
         result.Add(text);
     }
 }
 
-void MapRenderer::AddStopsSymbols(svg::Document& result, const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const {
+void MapRenderer::AddStopsSymbols(svg::Document& result, catalogue::StopRange stops, const SphereProjector& sp) const {
     for (const auto& circle : GetStopsSymbols(stops, sp)) {
         result.Add(circle);
     }
 }
 
-void MapRenderer::AddStopsLabels(svg::Document& result, const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const {
+void MapRenderer::AddStopsLabels(svg::Document& result, catalogue::StopRange stops, const SphereProjector& sp) const {
     for (const auto& text : GetStopsLabels(stops, sp)) {
         result.Add(text);
     }
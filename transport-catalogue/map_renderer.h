@@ -4,9 +4,12 @@
 #include "geo.h"
 #include "json.h"
 #include "domain.h"
+#include "transport_catalogue.h"
 
 #include <algorithm>
+#include <array>
 #include <limits>
+#include <vector>
 
 namespace renderer {
 
@@ -96,28 +99,50 @@ struct RenderSettings {
     std::vector<svg::Color> color_palette {};
 };
 
+// слои карты в порядке вывода
+enum class MapLayer {
+    ROUTE_LINES,
+    BUS_LABELS,
+    STOP_SYMBOLS,
+    STOP_LABELS
+};
+
+inline constexpr std::array<MapLayer, 4> MAP_LAYERS = {MapLayer::ROUTE_LINES, MapLayer::BUS_LABELS, MapLayer::STOP_SYMBOLS, MapLayer::STOP_LABELS};
+
+// Данные, общие для всех слоёв карты: справочник, остановки на маршрутах по возрастанию названий и проекция координат
+struct MapContext {
+    const catalogue::TransportCatalogue* catalogue;
+    std::vector<const catalogue::Stop*> stops;
+    SphereProjector projector;
+};
+
 class MapRenderer {
 public:
     MapRenderer(const RenderSettings& render_settings)
         : render_settings_(render_settings)
     {}
     
-    std::vector<svg::Polyline> GetRouteLines(const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const;
-    std::vector<svg::Text> GetBusLabel(const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const;
-    std::vector<svg::Circle> GetStopsSymbols(const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const;
-    std::vector<svg::Text> GetStopsLabels(const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const;    
+    std::vector<svg::Polyline> GetRouteLines(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const;
+    std::vector<svg::Text> GetBusLabel(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const;
+    std::vector<svg::Circle> GetStopsSymbols(catalogue::StopRange stops, const SphereProjector& sp) const;
+    std::vector<svg::Text> GetStopsLabels(catalogue::StopRange stops, const SphereProjector& sp) const;    
     // Метод для коллекции остановок
-    void CollectRouteStops(const std::map<std::string_view, const catalogue::Bus*>& buses, std::vector<geo::Coordinates>& route_stops_coord, std::map<std::string_view, const catalogue::Stop*>& stops) const;
+    void CollectRouteStops(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, std::vector<geo::Coordinates>& route_stops_coord, std::vector<const catalogue::Stop*>& stops) const;
     // Метод для добавления линий маршрутов
-    void AddRouteLines(svg::Document& result, const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const;
+    void AddRouteLines(svg::Document& result, const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const;
     // Метод для добавления надписей автобусов
-    void AddBusLabels(svg::Document& result, const std::map<std::string_view, const catalogue::Bus*>& buses, const SphereProjector& sp) const;
+    void AddBusLabels(svg::Document& result, const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses, const SphereProjector& sp) const;
     // Метод для добавления символов остановок
-    void AddStopsSymbols(svg::Document& result, const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const;
+    void AddStopsSymbols(svg::Document& result, catalogue::StopRange stops, const SphereProjector& sp) const;
     // Метод для добавления надписей остановок
-    void AddStopsLabels(svg::Document& result, const std::map<std::string_view, const catalogue::Stop*>& stops, const SphereProjector& sp) const;
+    void AddStopsLabels(svg::Document& result, catalogue::StopRange stops, const SphereProjector& sp) const;
     
-    svg::Document GetSVG(const std::map<std::string_view, const catalogue::Bus*>& buses) const;
+    svg::Document GetSVG(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses) const;
+
+    // Слои карты не зависят друг от друга, поэтому их можно строить отдельно
+    // и выводить по очереди в порядке MAP_LAYERS
+    MapContext GetMapContext(const catalogue::TransportCatalogue& catalogue, catalogue::BusRange buses) const;
+    void AddLayer(svg::Document& result, MapLayer layer, catalogue::BusRange buses, const MapContext& context) const;
     
 private:
     const RenderSettings render_settings_;
@@ -0,0 +1,34 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace storage {
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    //отображение остаётся действительным и после закрытия дескриптора
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::shared_ptr<const MappedFile>(new MappedFile(static_cast<const char*>(data), size));
+}
+
+MappedFile::~MappedFile() {
+    munmap(const_cast<char*>(data_), size_);
+}
+
+} // namespace storage
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace storage {
+
+// Файл, отображённый в память только для чтения.
+// Страницы отображения разделяются всеми процессами, открывшими тот же файл
+class MappedFile {
+public:
+    // nullptr, если файл не удалось открыть или отобразить
+    static std::shared_ptr<const MappedFile> Open(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* GetData() const {
+        return data_;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    MappedFile(const char* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    const char* data_;
+    size_t size_;
+};
+
+} // namespace storage
@@ -0,0 +1,158 @@
+#include "min_plus.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MIN_PLUS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+namespace min_plus {
+
+namespace {
+
+template <typename Weight>
+Weight AddWeights(Weight lhs, Weight rhs) {
+    return lhs + rhs;
+}
+
+//сумма фиксированных весов с насыщением, как в FixedPoint
+int32_t AddWeights(int32_t lhs, int32_t rhs) {
+    return static_cast<int32_t>(std::min(static_cast<int64_t>(lhs) + rhs, static_cast<int64_t>(std::numeric_limits<int32_t>::max())));
+}
+
+template <typename Weight>
+void RelaxRowScalar(Weight* weights, uint32_t* prev_edges, Weight via_weight, uint32_t via_prev_edge,
+                    const Weight* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    for (size_t j = 0; j < count; ++j) {
+        const Weight candidate = AddWeights(via_weight, through_weights[j]);
+        if (candidate < weights[j]) {
+            weights[j] = candidate;
+            prev_edges[j] = through_prev_edges[j] != NO_EDGE ? through_prev_edges[j] : via_prev_edge;
+        }
+    }
+}
+
+#ifdef MIN_PLUS_AVX2
+
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+//предыдущие рёбра улучшенных ячеек: ребро из строки промежуточной вершины,
+//а если его нет - ребро до промежуточной вершины
+__attribute__((target("avx2")))
+__m256i BlendPrevEdges(__m256i prev_edges, __m256i through_prev_edges, __m256i via_prev_edge, __m256i improved) {
+    const __m256i no_through_edge = _mm256_cmpeq_epi32(through_prev_edges, _mm256_set1_epi32(-1));
+    const __m256i new_prev_edges = _mm256_blendv_epi8(through_prev_edges, via_prev_edge, no_through_edge);
+    return _mm256_blendv_epi8(prev_edges, new_prev_edges, improved);
+}
+
+__attribute__((target("avx2")))
+void RelaxRowAvx2(double* weights, uint32_t* prev_edges, double via_weight, uint32_t via_prev_edge,
+                  const double* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    const __m256d via = _mm256_set1_pd(via_weight);
+    const __m256i via_prev = _mm256_set1_epi32(static_cast<int>(via_prev_edge));
+    //перестановка, собирающая младшие половины 64-битных масок в четыре 32-битные
+    const __m256i mask_lanes = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const __m256d candidate = _mm256_add_pd(via, _mm256_loadu_pd(through_weights + j));
+        const __m256d current = _mm256_loadu_pd(weights + j);
+        const __m256d improved = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_pd(improved) == 0) {
+            continue;
+        }
+        _mm256_storeu_pd(weights + j, _mm256_blendv_pd(current, candidate, improved));
+        const __m256i improved_edges = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(improved), mask_lanes);
+        const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges + j));
+        const __m128i through_prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(through_prev_edges + j));
+        const __m256i blended = BlendPrevEdges(_mm256_castsi128_si256(prev), _mm256_castsi128_si256(through_prev), via_prev, improved_edges);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_edges + j), _mm256_castsi256_si128(blended));
+    }
+    RelaxRowScalar(weights + j, prev_edges + j, via_weight, via_prev_edge, through_weights + j, through_prev_edges + j, count - j);
+}
+
+__attribute__((target("avx2")))
+void RelaxRowAvx2(float* weights, uint32_t* prev_edges, float via_weight, uint32_t via_prev_edge,
+                  const float* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    const __m256 via = _mm256_set1_ps(via_weight);
+    const __m256i via_prev = _mm256_set1_epi32(static_cast<int>(via_prev_edge));
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        const __m256 candidate = _mm256_add_ps(via, _mm256_loadu_ps(through_weights + j));
+        const __m256 current = _mm256_loadu_ps(weights + j);
+        const __m256 improved = _mm256_cmp_ps(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_ps(improved) == 0) {
+            continue;
+        }
+        _mm256_storeu_ps(weights + j, _mm256_blendv_ps(current, candidate, improved));
+        const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges + j));
+        const __m256i through_prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through_prev_edges + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges + j), BlendPrevEdges(prev, through_prev, via_prev, _mm256_castps_si256(improved)));
+    }
+    RelaxRowScalar(weights + j, prev_edges + j, via_weight, via_prev_edge, through_weights + j, through_prev_edges + j, count - j);
+}
+
+__attribute__((target("avx2")))
+void RelaxRowAvx2(int32_t* weights, uint32_t* prev_edges, int32_t via_weight, uint32_t via_prev_edge,
+                  const int32_t* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    const __m256i via = _mm256_set1_epi32(via_weight);
+    const __m256i via_prev = _mm256_set1_epi32(static_cast<int>(via_prev_edge));
+    const __m256i max_weight = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        //веса неотрицательны, поэтому беззнаковая сумма не переполняется, а минимум с INT32_MAX насыщает её
+        const __m256i sum = _mm256_add_epi32(via, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through_weights + j)));
+        const __m256i candidate = _mm256_min_epu32(sum, max_weight);
+        const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + j));
+        const __m256i improved = _mm256_cmpgt_epi32(current, candidate);
+        if (_mm256_movemask_epi8(improved) == 0) {
+            continue;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(weights + j), _mm256_blendv_epi8(current, candidate, improved));
+        const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges + j));
+        const __m256i through_prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through_prev_edges + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges + j), BlendPrevEdges(prev, through_prev, via_prev, improved));
+    }
+    RelaxRowScalar(weights + j, prev_edges + j, via_weight, via_prev_edge, through_weights + j, through_prev_edges + j, count - j);
+}
+
+#endif // MIN_PLUS_AVX2
+
+template <typename Weight>
+void RelaxRowDispatch(Weight* weights, uint32_t* prev_edges, Weight via_weight, uint32_t via_prev_edge,
+                      const Weight* through_weights, const uint32_t* through_prev_edges, size_t count) {
+#ifdef MIN_PLUS_AVX2
+    if (HasAvx2()) {
+        RelaxRowAvx2(weights, prev_edges, via_weight, via_prev_edge, through_weights, through_prev_edges, count);
+        return;
+    }
+#endif
+    RelaxRowScalar(weights, prev_edges, via_weight, via_prev_edge, through_weights, through_prev_edges, count);
+}
+
+} // namespace
+
+void RelaxRow(double* weights, uint32_t* prev_edges, double via_weight, uint32_t via_prev_edge,
+              const double* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    RelaxRowDispatch(weights, prev_edges, via_weight, via_prev_edge, through_weights, through_prev_edges, count);
+}
+
+void RelaxRow(float* weights, uint32_t* prev_edges, float via_weight, uint32_t via_prev_edge,
+              const float* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    RelaxRowDispatch(weights, prev_edges, via_weight, via_prev_edge, through_weights, through_prev_edges, count);
+}
+
+void RelaxRow(int32_t* weights, uint32_t* prev_edges, int32_t via_weight, uint32_t via_prev_edge,
+              const int32_t* through_weights, const uint32_t* through_prev_edges, size_t count) {
+    RelaxRowDispatch(weights, prev_edges, via_weight, via_prev_edge, through_weights, through_prev_edges, count);
+}
+
+} // namespace min_plus
+
+} // namespace graph
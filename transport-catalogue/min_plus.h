@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace graph {
+
+namespace min_plus {
+
+// номер ребра "предыдущего ребра нет" в матрице предыдущих рёбер
+constexpr uint32_t NO_EDGE = UINT32_MAX;
+
+// Min-plus релаксация отрезка строки таблицы через промежуточную вершину:
+//   weights[j] = min(weights[j], via_weight + through_weights[j]),
+// и при улучшении prev_edges[j] = through_prev_edges[j], а если его нет - via_prev_edge.
+// Недостижимость задаётся бесконечностью (для int32_t - INT32_MAX), сумма с ней не улучшает ячейку.
+// Веса int32_t - фиксированная точка, их сумма насыщается до INT32_MAX.
+// Если процессор поддерживает AVX2, используется векторная версия; результат совпадает со скалярной
+void RelaxRow(double* weights, uint32_t* prev_edges, double via_weight, uint32_t via_prev_edge,
+              const double* through_weights, const uint32_t* through_prev_edges, size_t count);
+void RelaxRow(float* weights, uint32_t* prev_edges, float via_weight, uint32_t via_prev_edge,
+              const float* through_weights, const uint32_t* through_prev_edges, size_t count);
+void RelaxRow(int32_t* weights, uint32_t* prev_edges, int32_t via_weight, uint32_t via_prev_edge,
+              const int32_t* through_weights, const uint32_t* through_prev_edges, size_t count);
+
+} // namespace min_plus
+
+} // namespace graph
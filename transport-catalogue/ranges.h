@@ -22,6 +22,16 @@ public:
     It end() const {
         return end_;
     }
+    // для итераторов произвольного доступа
+    size_t size() const {
+        return static_cast<size_t>(end_ - begin_);
+    }
+    bool empty() const {
+        return begin_ == end_;
+    }
+    decltype(auto) operator[](size_t index) const {
+        return begin_[index];
+    }
 
 private:
     It begin_;
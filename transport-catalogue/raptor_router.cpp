@@ -0,0 +1,161 @@
+#include "raptor_router.h"
+
+#include <algorithm>
+
+namespace catalogue {
+
+RaptorRouter::RaptorRouter(const TransportCatalogue& catalogue, int bus_wait_time, double bus_velocity)
+    : wait_time_(static_cast<double>(bus_wait_time))
+    , velocity_(bus_velocity * (100.0 / 6.0)) {
+    for (const Stop* stop : catalogue.GetSortedAllStops()) {
+        stop_index_[stop->GetName()] = stops_.size();
+        stops_.push_back(stop);
+    }
+    stop_patterns_.resize(stops_.size());
+
+    for (const Bus* bus : catalogue.GetSortedAllBuses()) {
+        const RouteRange route = catalogue.GetRoute(*bus);
+        const std::vector<StopId> route_stops(route.begin(), route.end());
+        AddPattern(bus, route_stops, catalogue);
+        if (!bus->is_circle) {
+            AddPattern(bus, {route_stops.rbegin(), route_stops.rend()}, catalogue);
+        }
+    }
+}
+
+//добавляет направление движения автобуса
+void RaptorRouter::AddPattern(const Bus* bus, const std::vector<StopId>& route, const TransportCatalogue& catalogue) {
+    if (route.size() < 2) {
+        return;
+    }
+    Pattern pattern{bus, {}, {}};
+    pattern.stops.reserve(route.size());
+    pattern.distances.reserve(route.size());
+    for (size_t i = 0; i < route.size(); ++i) {
+        const size_t stop_id = stop_index_.at(catalogue.GetStopName(route[i]));
+        pattern.stops.push_back(stop_id);
+        pattern.distances.push_back(i == 0 ? 0 : pattern.distances.back() + catalogue.GetDistance(route[i - 1], route[i]));
+        stop_patterns_[stop_id].push_back({patterns_.size(), i});
+    }
+    patterns_.push_back(std::move(pattern));
+}
+
+double RaptorRouter::GetRideTime(const Pattern& pattern, size_t board_position, size_t alight_position) const {
+    return static_cast<double>(pattern.distances[alight_position] - pattern.distances[board_position]) / velocity_;
+}
+
+//проезд вдоль направления: высадка по текущей посадке, затем проверка более выгодной посадки
+void RaptorRouter::ScanPattern(size_t pattern_id, size_t target, double max_time, Workspace& workspace) const {
+    const Pattern& pattern = patterns_[pattern_id];
+    const auto& previous = workspace.rounds_[workspace.rounds_.size() - 2];
+    auto& current = workspace.rounds_.back();
+    auto& best = workspace.best_arrivals_;
+
+    size_t board = NONE;
+    double board_time = INFINITE_TIME;
+    for (size_t position = workspace.pattern_start_[pattern_id]; position < pattern.stops.size(); ++position) {
+        const size_t stop_id = pattern.stops[position];
+        double trip_time = INFINITE_TIME;
+        if (board != NONE) {
+            trip_time = board_time + GetRideTime(pattern, board, position);
+            if (trip_time < best[stop_id] && (target == NONE || trip_time < best[target]) && !(max_time < trip_time)) {
+                current[stop_id] = {trip_time, pattern_id, board, position, true};
+                best[stop_id] = trip_time;
+                if (!workspace.is_marked_[stop_id]) {
+                    workspace.is_marked_[stop_id] = true;
+                    workspace.marked_stops_.push_back(stop_id);
+                }
+            }
+        }
+        const double arrival = previous[stop_id].arrival;
+        if (arrival != INFINITE_TIME && arrival + wait_time_ < trip_time) {
+            board = position;
+            board_time = arrival + wait_time_;
+        }
+    }
+}
+
+//раунды поиска из source; при target == NONE ищутся времена прибытия на все остановки
+void RaptorRouter::RunRounds(size_t source, size_t target, double max_time, Workspace& workspace) const {
+    const size_t stop_count = stops_.size();
+
+    workspace.rounds_.clear();
+    workspace.rounds_.emplace_back(stop_count, Workspace::Label{INFINITE_TIME, NONE, NONE, NONE, false});
+    workspace.best_arrivals_.assign(stop_count, INFINITE_TIME);
+    workspace.is_marked_.assign(stop_count, false);
+    workspace.marked_stops_.clear();
+    workspace.pattern_start_.assign(patterns_.size(), NONE);
+    workspace.queued_patterns_.clear();
+
+    workspace.rounds_[0][source] = {0.0, NONE, NONE, NONE, true};
+    workspace.best_arrivals_[source] = 0.0;
+    workspace.marked_stops_.push_back(source);
+
+    while (!workspace.marked_stops_.empty()) {
+        //направления, проходящие через улучшенные в прошлом раунде остановки
+        for (const size_t stop_id : workspace.marked_stops_) {
+            workspace.is_marked_[stop_id] = false;
+            for (const auto& [pattern_id, position] : stop_patterns_[stop_id]) {
+                size_t& start = workspace.pattern_start_[pattern_id];
+                if (start == NONE) {
+                    workspace.queued_patterns_.push_back(pattern_id);
+                }
+                start = std::min(start, position);
+            }
+        }
+        workspace.marked_stops_.clear();
+
+        workspace.rounds_.push_back(workspace.rounds_.back());
+        for (auto& label : workspace.rounds_.back()) {
+            label.improved = false;
+        }
+        for (const size_t pattern_id : workspace.queued_patterns_) {
+            ScanPattern(pattern_id, target, max_time, workspace);
+            workspace.pattern_start_[pattern_id] = NONE;
+        }
+        workspace.queued_patterns_.clear();
+    }
+}
+
+void RaptorRouter::ComputeArrivals(std::string_view stop_from, Workspace& workspace, double max_time) const {
+    RunRounds(stop_index_.at(stop_from), NONE, max_time, workspace);
+}
+
+double RaptorRouter::GetArrivalTime(std::string_view stop, const Workspace& workspace) const {
+    return workspace.best_arrivals_[stop_index_.at(stop)];
+}
+
+std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(std::string_view stop_from, std::string_view stop_to, Workspace& workspace) const {
+    const size_t target = stop_index_.at(stop_to);
+    RunRounds(stop_index_.at(stop_from), target, INFINITE_TIME, workspace);
+    if (workspace.best_arrivals_[target] == INFINITE_TIME) {
+        return std::nullopt;
+    }
+
+    Journey journey{workspace.best_arrivals_[target], {}};
+    size_t round = workspace.rounds_.size() - 1;
+    size_t stop_id = target;
+    while (true) {
+        while (!workspace.rounds_[round][stop_id].improved) {
+            --round;
+        }
+        if (round == 0) {
+            break;
+        }
+        const auto& label = workspace.rounds_[round][stop_id];
+        const Pattern& pattern = patterns_[label.pattern];
+        stop_id = pattern.stops[label.board_position];
+        journey.legs.push_back({
+            stops_[stop_id],
+            pattern.bus,
+            label.alight_position - label.board_position,
+            GetRideTime(pattern, label.board_position, label.alight_position)
+        });
+        --round;
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+
+    return journey;
+}
+
+} // namespace catalogue
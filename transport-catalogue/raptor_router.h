@@ -0,0 +1,97 @@
+#pragma once
+
+#include "domain.h"
+#include "transport_catalogue.h"
+
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace catalogue {
+
+// Поиск маршрута по раундам (RAPTOR) прямо по маршрутам автобусов.
+// Раунд k находит лучшие времена прибытия на остановки ровно с k посадками,
+// поэтому граф из рёбер между всеми парами остановок маршрута не строится
+class RaptorRouter {
+public:
+    // поездка на одном автобусе: ожидание на stop_from и span_count пролётов
+    struct Leg {
+        const Stop* stop_from;
+        const Bus* bus;
+        size_t span_count;
+        double ride_time;
+    };
+
+    struct Journey {
+        double total_time;
+        std::vector<Leg> legs;
+    };
+
+    // Буферы поиска, переиспользуемые между запросами
+    class Workspace {
+    private:
+        friend class RaptorRouter;
+
+        struct Label {
+            double arrival;
+            size_t pattern;
+            size_t board_position;
+            size_t alight_position;
+            bool improved;
+        };
+
+        std::vector<std::vector<Label>> rounds_;
+        std::vector<double> best_arrivals_;
+        std::vector<size_t> marked_stops_;
+        std::vector<bool> is_marked_;
+        std::vector<size_t> pattern_start_;
+        std::vector<size_t> queued_patterns_;
+    };
+
+    RaptorRouter(const TransportCatalogue& catalogue, int bus_wait_time, double bus_velocity);
+
+    std::optional<Journey> BuildRoute(std::string_view stop_from, std::string_view stop_to, Workspace& workspace) const;
+
+    // времена прибытия из stop_from на все остановки, без отсечения по цели;
+    // остановки, до которых дольше max_time, считаются недостижимыми
+    void ComputeArrivals(std::string_view stop_from, Workspace& workspace, double max_time = INFINITE_TIME) const;
+    // время прибытия после ComputeArrivals, бесконечность - остановка недостижима
+    double GetArrivalTime(std::string_view stop, const Workspace& workspace) const;
+
+    // остановки в порядке их номеров (по алфавиту)
+    const std::vector<const Stop*>& GetStops() const {
+        return stops_;
+    }
+
+private:
+    static constexpr double INFINITE_TIME = std::numeric_limits<double>::infinity();
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    // направление движения автобуса: остановки и накопленные дорожные расстояния
+    struct Pattern {
+        const Bus* bus;
+        std::vector<size_t> stops;
+        std::vector<int> distances;
+    };
+
+    struct PatternStop {
+        size_t pattern;
+        size_t position;
+    };
+
+    double wait_time_;
+    double velocity_;
+    std::vector<const Stop*> stops_;
+    std::unordered_map<std::string_view, size_t> stop_index_;
+    std::vector<Pattern> patterns_;
+    std::vector<std::vector<PatternStop>> stop_patterns_;
+
+    void AddPattern(const Bus* bus, const std::vector<StopId>& route, const TransportCatalogue& catalogue);
+    double GetRideTime(const Pattern& pattern, size_t board_position, size_t alight_position) const;
+    void ScanPattern(size_t pattern_id, size_t target, double max_time, Workspace& workspace) const;
+    void RunRounds(size_t source, size_t target, double max_time, Workspace& workspace) const;
+};
+
+} // namespace catalogue
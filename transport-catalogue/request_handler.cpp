@@ -1,5 +1,7 @@
 #include "request_handler.h"
 
+#include <sstream>
+
 bool RequestHandler::IsBusNumber(const std::string_view bus_number) const {
     return catalogue_.FindBus(bus_number);
 }
@@ -8,23 +10,60 @@ bool RequestHandler::IsStopName(const std::string_view stop_name) const {
     return catalogue_.FindStop(stop_name);
 }
 
-catalogue::BusInfo RequestHandler::GetBusStat(const std::string_view& bus_number) const {
+const catalogue::BusInfo* RequestHandler::GetBusStat(const std::string_view& bus_number) const {
     return catalogue_.GetBusInfo(bus_number);
 }
 
-const std::set<std::string_view> RequestHandler::GetBusesByStop(std::string_view stop_name) const {
+catalogue::TransportCatalogue::BusNamesRange RequestHandler::GetBusesByStop(std::string_view stop_name) const {
     return catalogue_.GetStopInfo(stop_name);
 }
 
 svg::Document RequestHandler::RenderMap() const {
-    return renderer_.GetSVG(catalogue_.GetSortedAllBuses());
+    return renderer_.GetSVG(catalogue_, catalogue_.GetSortedAllBuses());
+}
+
+std::string RequestHandler::RenderMapText() {
+    const catalogue::BusRange buses = catalogue_.GetSortedAllBuses();
+    const renderer::MapContext context = renderer_.GetMapContext(catalogue_, buses);
+
+    std::array<std::string, renderer::MAP_LAYERS.size()> layers;
+    std::vector<scheduling::TaskScheduler::Task> subtasks;
+    for (size_t i = 0; i < renderer::MAP_LAYERS.size(); ++i) {
+        subtasks.push_back([this, &buses, &context, &layers, i] {
+            svg::Document layer;
+            renderer_.AddLayer(layer, renderer::MAP_LAYERS[i], buses, context);
+            std::ostringstream strm;
+            layer.RenderObjects(strm);
+            layers[i] = strm.str();
+        });
+    }
+    scheduler_.RunAndWait(std::move(subtasks));
+
+    std::ostringstream strm;
+    svg::Document::RenderBegin(strm);
+    for (const auto& layer : layers) {
+        strm << layer;
+    }
+    svg::Document::RenderEnd(strm);
+    return strm.str();
+}
+
+void RequestHandler::RunTasks(std::vector<scheduling::TaskScheduler::WeightedTask> tasks) {
+    scheduler_.Run(std::move(tasks));
+}
+
+catalogue::TransportRouter::RouteItems RequestHandler::GetRouteItems(const std::string_view stop_from, const std::string_view stop_to) const {
+    return router_.GetRouteInfo(stop_from, stop_to);
+}
+
+catalogue::TransportRouter::TravelTimeMatrix RequestHandler::GetTravelTimeMatrix(const std::vector<std::string_view>& stops_from, const std::vector<std::string_view>& stops_to) const {
+    return router_.GetTravelTimeMatrix(stops_from, stops_to);
 }
 
-const std::optional<graph::Router<double>::RouteInfo> RequestHandler::GetOptimalRoute(const std::string_view stop_from, const std::string_view stop_to) const {
-    auto route_items = router_.GetRouteInfo(stop_from, stop_to);
-    return route_items.route_info_;
+std::vector<catalogue::TransportRouter::ReachableStop> RequestHandler::GetReachableStops(const std::string_view stop_from, double max_time) const {
+    return router_.GetReachableStops(stop_from, max_time);
 }
 
-const graph::DirectedWeightedGraph<double>* RequestHandler::GetRouterGraph(const std::string_view stop_from, const std::string_view stop_to) const {
-    return std::move(router_.GetRouteInfo(stop_from, stop_to).route_graph_);
+catalogue::TransportRouter::RoutingStats RequestHandler::GetRoutingStats() const {
+    return router_.GetRoutingStats();
 }
@@ -3,28 +3,46 @@
 #include "transport_catalogue.h"
 #include "map_renderer.h"
 #include "transport_router.h"
+#include "task_scheduler.h"
+
+#include <string>
+#include <vector>
 
 class RequestHandler {
 public:
    
-    explicit RequestHandler(const catalogue::TransportCatalogue& catalogue, const renderer::MapRenderer& renderer, const catalogue::TransportRouter& router)
+    // worker_count - число потоков для ответов на запросы (0 - по числу ядер)
+    explicit RequestHandler(const catalogue::TransportCatalogue& catalogue, const renderer::MapRenderer& renderer, const catalogue::TransportRouter& router, size_t worker_count = 1)
         : catalogue_(catalogue)
         , renderer_(renderer)
         , router_(router)
+        , scheduler_(worker_count)
     {
     }
 
-    catalogue::BusInfo GetBusStat(const std::string_view& bus_number) const;
-    const std::set<std::string_view> GetBusesByStop(std::string_view stop_name) const;
+    //статистика маршрута, nullptr - маршрут не найден
+    const catalogue::BusInfo* GetBusStat(const std::string_view& bus_number) const;
+    //отсортированные номера автобусов без копирования
+    catalogue::TransportCatalogue::BusNamesRange GetBusesByStop(std::string_view stop_name) const;
     bool IsBusNumber(const std::string_view bus_number) const;
     bool IsStopName(const std::string_view stop_name) const;    
-    const std::optional<graph::Router<double>::RouteInfo> GetOptimalRoute(const std::string_view stop_from, const std::string_view stop_to) const;
-    const graph::DirectedWeightedGraph<double>* GetRouterGraph(const std::string_view stop_from, const std::string_view stop_to) const;    
+    //маршрут вместе с графом, которому принадлежат его рёбра; строится один раз на запрос
+    catalogue::TransportRouter::RouteItems GetRouteItems(const std::string_view stop_from, const std::string_view stop_to) const;
+    
+    catalogue::TransportRouter::TravelTimeMatrix GetTravelTimeMatrix(const std::vector<std::string_view>& stops_from, const std::vector<std::string_view>& stops_to) const;
+    std::vector<catalogue::TransportRouter::ReachableStop> GetReachableStops(const std::string_view stop_from, double max_time) const;
+    catalogue::TransportRouter::RoutingStats GetRoutingStats() const;
     
     svg::Document RenderMap() const;    
+    // svg-текст карты; слои карты строятся и выводятся отдельными подзадачами планировщика
+    std::string RenderMapText();
+
+    // выполняет задачи ответов на запросы, cost - ожидаемая трудоёмкость задачи
+    void RunTasks(std::vector<scheduling::TaskScheduler::WeightedTask> tasks);
 
 private:
     const catalogue::TransportCatalogue& catalogue_;
     const renderer::MapRenderer& renderer_;    
     const catalogue::TransportRouter& router_;    
+    scheduling::TaskScheduler scheduler_;
 };
@@ -1,117 +1,310 @@
 #pragma once
 
 #include "graph.h"
+#include "min_plus.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace graph {
 
+// Вес с фиксированной точкой: целое число долей 1 / TicksPerUnit.
+// Сумма, не помещающаяся в int32_t, равна Max(), то есть путь считается недостижимым
+template <int32_t TicksPerUnit>
+class FixedPoint {
+public:
+    constexpr FixedPoint() = default;
+
+    explicit FixedPoint(double value)
+        : ticks_(static_cast<int32_t>(std::min(std::llround(value * TicksPerUnit), static_cast<long long>(MAX_TICKS)))) {
+    }
+
+    explicit operator double() const {
+        return static_cast<double>(ticks_) / TicksPerUnit;
+    }
+
+    static constexpr FixedPoint Max() {
+        FixedPoint result;
+        result.ticks_ = MAX_TICKS;
+        return result;
+    }
+
+    friend FixedPoint operator+(FixedPoint lhs, FixedPoint rhs) {
+        FixedPoint result;
+        result.ticks_ = static_cast<int32_t>(std::min(static_cast<int64_t>(lhs.ticks_) + rhs.ticks_, static_cast<int64_t>(MAX_TICKS)));
+        return result;
+    }
+
+    friend bool operator<(FixedPoint lhs, FixedPoint rhs) {
+        return lhs.ticks_ < rhs.ticks_;
+    }
+
+    friend bool operator>(FixedPoint lhs, FixedPoint rhs) {
+        return rhs < lhs;
+    }
+
+private:
+    static constexpr int32_t MAX_TICKS = std::numeric_limits<int32_t>::max();
+    int32_t ticks_ = 0;
+};
+
+// время в пути в таблице всех пар с точностью 1/1024 минуты
+using FixedPointMinutes = FixedPoint<1024>;
+
 template <typename Weight>
+struct Route {
+    Weight weight;
+    std::vector<EdgeId> edges;
+};
+
+// Таблица кратчайших путей между всеми парами вершин.
+// TableWeight - тип весов в таблице: Weight, float или FixedPoint. Веса рёбер
+// переводятся в него при построении. Рёбра маршрута всегда берутся из графа, и вес
+// маршрута BuildRoute точный; GetRouteWeight возвращает вес из таблицы с её точностью
+template <typename Weight, typename TableWeight = Weight>
 class Router {
 private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
-    explicit Router(const Graph& graph);
+    // thread_count - число потоков для построения таблицы (0 - по числу ядер)
+    explicit Router(const Graph& graph, size_t thread_count = 1);
+    // таблица, построенная ранее (например, отображённая в память из файла);
+    // table_owner продлевает жизнь памяти таблицы
+    Router(const Graph& graph, const char* table_data, size_t table_size, std::shared_ptr<const void> table_owner);
 
-    struct RouteInfo {
-        Weight weight;
-        std::vector<EdgeId> edges;
-    };
+    using RouteInfo = Route<Weight>;
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    // вес кратчайшего пути без восстановления рёбер, с точностью TableWeight
+    std::optional<Weight> GetRouteWeight(VertexId from, VertexId to) const;
+
+    // Таблица для сохранения: матрица весов, за ней матрица предыдущих рёбер.
+    // Конструктор из готовой таблицы принимает те же байты
+    template <typename Output>
+    void WriteTable(Output& output) const {
+        output.write(reinterpret_cast<const char*>(weights_table_), vertex_count_ * vertex_count_ * sizeof(TableWeight));
+        output.write(reinterpret_cast<const char*>(prev_edges_table_), vertex_count_ * vertex_count_ * sizeof(TableEdgeId));
+    }
+    size_t GetTableSize() const {
+        return vertex_count_ * vertex_count_ * GetTableCellSize();
+    }
+    static constexpr size_t GetTableCellSize() {
+        return sizeof(TableWeight) + sizeof(TableEdgeId);
+    }
 
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    // Таблица хранится двумя матрицами V x V (построчно): весов путей и последних рёбер путей.
+    // Недостижимость задаётся весом INFINITE_WEIGHT, отсутствие предыдущего ребра - NO_EDGE.
+    // Номера рёбер 32-битные
+    using TableEdgeId = uint32_t;
+    static_assert(std::is_trivially_copyable_v<TableWeight>,
+                  "Router table weights are saved and mapped as raw bytes");
+
+    static constexpr TableEdgeId NO_EDGE = min_plus::NO_EDGE;
+
+    static constexpr TableWeight INFINITE_WEIGHT = [] {
+        if constexpr (std::is_floating_point_v<TableWeight>) {
+            return std::numeric_limits<TableWeight>::infinity();
+        } else {
+            return TableWeight::Max();
+        }
+    }();
+
+    // число строк таблицы в одной задаче параллельной релаксации
+    static constexpr size_t ROWS_PER_TASK = 64;
+
+    size_t GetCellIndex(VertexId vertex_from, VertexId vertex_to) const {
+        return vertex_from * vertex_count_ + vertex_to;
+    }
+
+    bool IsReachable(VertexId vertex_from, VertexId vertex_to) const {
+        return weights_table_[GetCellIndex(vertex_from, vertex_to)] < INFINITE_WEIGHT;
+    }
 
     void InitializeRoutesInternalData(const Graph& graph) {
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+        if (graph.GetEdgeCount() >= NO_EDGE) {
+            throw std::length_error("Too many edges for Router table");
+        }
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            weights_[GetCellIndex(vertex, vertex)] = ZERO_WEIGHT;
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+                if (edge.weight < Weight{}) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                const TableWeight weight = static_cast<TableWeight>(edge.weight);
+                const size_t cell = GetCellIndex(vertex, edge.to);
+                if (!(weights_[cell] < INFINITE_WEIGHT) || weights_[cell] > weight) {
+                    weights_[cell] = weight;
+                    prev_edges_[cell] = static_cast<TableEdgeId>(edge_id);
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    // строка таблицы через одну промежуточную вершину; веса FixedPoint передаются ядру как int32_t
+    void RelaxRow(VertexId vertex_from, VertexId vertex_through) {
+        const size_t cell = GetCellIndex(vertex_from, 0);
+        const size_t through_cell = GetCellIndex(vertex_through, 0);
+        const size_t via_cell = GetCellIndex(vertex_from, vertex_through);
+        if constexpr (std::is_floating_point_v<TableWeight>) {
+            min_plus::RelaxRow(weights_.data() + cell, prev_edges_.data() + cell, weights_[via_cell], prev_edges_[via_cell],
+                               weights_.data() + through_cell, prev_edges_.data() + through_cell, vertex_count_);
+        } else {
+            static_assert(sizeof(TableWeight) == sizeof(int32_t));
+            int32_t* weights = reinterpret_cast<int32_t*>(weights_.data());
+            min_plus::RelaxRow(weights + cell, prev_edges_.data() + cell, weights[via_cell], prev_edges_[via_cell],
+                               weights + through_cell, prev_edges_.data() + through_cell, vertex_count_);
+        }
+    }
+
+    // выполняет task(0), ..., task(task_count - 1) в нескольких потоках
+    template <typename Task>
+    void RunParallel(size_t task_count, Task task) const {
+        const size_t worker_count = std::min(thread_count_, task_count);
+        if (worker_count <= 1) {
+            for (size_t i = 0; i < task_count; ++i) {
+                task(i);
+            }
+            return;
+        }
+        std::atomic<size_t> next_task{0};
+        const auto worker = [&next_task, task_count, &task] {
+            for (size_t i = next_task++; i < task_count; i = next_task++) {
+                task(i);
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(worker_count - 1);
+        for (size_t i = 1; i < worker_count; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+    // Флойд - Уоршелл в порядке промежуточная вершина - строка - столбец, как в исходной версии,
+    // поэтому из путей одинакового веса выбираются те же. При промежуточной вершине k
+    // строка k и столбец k не меняются (вес пути из k в k нулевой), так что строки
+    // таблицы релаксируются независимо и считаются параллельно, а каждая строка - ядром min_plus.
+    // Блочный порядок здесь не подходит: он меняет выбор среди равных путей, а при рёбрах
+    // нулевого веса оставляет в таблице предыдущих рёбер циклы
+    void RelaxRoutesInternalData() {
+        const size_t task_count = (vertex_count_ + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+        for (VertexId vertex_through = 0; vertex_through < vertex_count_; ++vertex_through) {
+            RunParallel(task_count, [this, vertex_through](size_t task) {
+                const VertexId rows_end = std::min(vertex_count_, (task + 1) * ROWS_PER_TASK);
+                for (VertexId vertex_from = task * ROWS_PER_TASK; vertex_from < rows_end; ++vertex_from) {
+                    if (vertex_from != vertex_through && IsReachable(vertex_from, vertex_through)) {
+                        RelaxRow(vertex_from, vertex_through);
                     }
                 }
-            }
+            });
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr TableWeight ZERO_WEIGHT{};
     const Graph& graph_;
-    RoutesInternalData routes_internal_data_;
+    size_t vertex_count_;
+    size_t thread_count_;
+    std::vector<TableWeight> weights_;
+    std::vector<TableEdgeId> prev_edges_;
+    // таблица для запросов: weights_ и prev_edges_ или внешняя память table_owner_
+    const TableWeight* weights_table_ = nullptr;
+    const TableEdgeId* prev_edges_table_ = nullptr;
+    std::shared_ptr<const void> table_owner_;
 };
 
-template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+template <typename Weight, typename TableWeight>
+Router<Weight, TableWeight>::Router(const Graph& graph, size_t thread_count)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , vertex_count_(graph.GetVertexCount())
+    , thread_count_(thread_count != 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency()))
+    , weights_(graph.GetVertexCount() * graph.GetVertexCount(), INFINITE_WEIGHT)
+    , prev_edges_(graph.GetVertexCount() * graph.GetVertexCount(), NO_EDGE)
+    , weights_table_(weights_.data())
+    , prev_edges_table_(prev_edges_.data())
 {
     InitializeRoutesInternalData(graph);
+    RelaxRoutesInternalData();
+}
 
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+template <typename Weight, typename TableWeight>
+Router<Weight, TableWeight>::Router(const Graph& graph, const char* table_data, size_t table_size, std::shared_ptr<const void> table_owner)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , thread_count_(1)
+    , weights_table_(reinterpret_cast<const TableWeight*>(table_data))
+    , prev_edges_table_(reinterpret_cast<const TableEdgeId*>(table_data + vertex_count_ * vertex_count_ * sizeof(TableWeight)))
+    , table_owner_(std::move(table_owner))
+{
+    if (table_size != GetTableSize()) {
+        throw std::invalid_argument("Router table size does not match the graph");
     }
 }
 
-template <typename Weight>
-std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-                                                                             VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+template <typename Weight, typename TableWeight>
+std::optional<typename Router<Weight, TableWeight>::RouteInfo> Router<Weight, TableWeight>::BuildRoute(VertexId from,
+                                                                                               VertexId to) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    if (!IsReachable(from, to)) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (TableEdgeId edge_id = prev_edges_table_[GetCellIndex(from, to)];
+         edge_id != NO_EDGE;
+         edge_id = prev_edges_table_[GetCellIndex(from, graph_.GetEdge(edge_id).from)])
     {
-        edges.push_back(*edge_id);
+        // кратчайший путь проходит каждую вершину не больше раза; более длинная цепочка
+        // предыдущих рёбер означает испорченную таблицу (например, чужой файл кэша)
+        if (edges.size() == vertex_count_) {
+            throw std::logic_error("Router table contains a cycle of previous edges");
+        }
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
 
+    // в таблице Weight вес пути точный; вес из float или FixedPoint округлён,
+    // поэтому он заново складывается из весов рёбер графа
+    Weight weight{};
+    if constexpr (std::is_same_v<TableWeight, Weight>) {
+        weight = weights_table_[GetCellIndex(from, to)];
+    } else {
+        for (const EdgeId edge_id : edges) {
+            weight = weight + graph_.GetEdge(edge_id).weight;
+        }
+    }
+
     return RouteInfo{weight, std::move(edges)};
 }
 
+template <typename Weight, typename TableWeight>
+std::optional<Weight> Router<Weight, TableWeight>::GetRouteWeight(VertexId from, VertexId to) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    if (!IsReachable(from, to)) {
+        return std::nullopt;
+    }
+    return static_cast<Weight>(weights_table_[GetCellIndex(from, to)]);
+}
+
 }  // namespace graph
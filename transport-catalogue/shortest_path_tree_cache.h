@@ -0,0 +1,171 @@
+#pragma once
+
+#include "dijkstra_router.h"
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Кэш деревьев кратчайших путей по вершине отправления.
+// Дерево строится одним полным поиском Дейкстры при первом запросе из вершины,
+// после чего маршруты из неё восстанавливаются проходом по предыдущим рёбрам.
+// Хранится не больше capacity деревьев, вытесняется дольше всех не использовавшееся.
+// Доступ к кэшу защищён мьютексом, сам поиск идёт вне блокировки в буферах вызывающего
+template <typename Weight>
+class ShortestPathTreeCache {
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+    using Workspace = typename DijkstraRouter<Weight>::Workspace;
+
+    // дерево из одной вершины: вес пути (бесконечность - вершина недостижима)
+    // и последнее ребро пути до каждой вершины
+    struct Tree {
+        std::vector<Weight> weights;
+        std::vector<uint32_t> prev_edges;
+
+        bool IsReached(VertexId vertex) const {
+            return weights[vertex] < INFINITE_WEIGHT;
+        }
+    };
+
+    struct Stats {
+        size_t hit_count = 0;
+        size_t miss_count = 0;
+        size_t eviction_count = 0;
+        size_t tree_count = 0;
+        size_t memory_bytes = 0;
+        // вершины, обработанные поисками при построении деревьев
+        size_t settled_vertex_count = 0;
+    };
+
+    ShortestPathTreeCache(const CompressedGraph<Weight>& graph, const DijkstraRouter<Weight>& router, size_t capacity);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, Workspace& workspace);
+
+    // дерево из from: из кэша или новым поиском в workspace
+    std::shared_ptr<const Tree> GetTree(VertexId from, Workspace& workspace);
+
+    Stats GetStats() const;
+
+private:
+    static_assert(std::numeric_limits<Weight>::has_infinity, "Unreached vertices are marked with infinite weight");
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::infinity();
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+    using Entry = std::pair<VertexId, std::shared_ptr<const Tree>>;
+
+    std::shared_ptr<const Tree> MakeTree(VertexId from, Workspace& workspace) const;
+
+    const CompressedGraph<Weight>& graph_;
+    const DijkstraRouter<Weight>& router_;
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    // в начале списка - последние использованные деревья
+    std::list<Entry> entries_;
+    std::unordered_map<VertexId, typename std::list<Entry>::iterator> index_;
+    Stats stats_;
+};
+
+template <typename Weight>
+ShortestPathTreeCache<Weight>::ShortestPathTreeCache(const CompressedGraph<Weight>& graph, const DijkstraRouter<Weight>& router, size_t capacity)
+    : graph_(graph)
+    , router_(router)
+    , capacity_(std::max<size_t>(capacity, 1)) {
+    if (graph.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many edges for shortest path trees");
+    }
+}
+
+template <typename Weight>
+std::shared_ptr<const typename ShortestPathTreeCache<Weight>::Tree> ShortestPathTreeCache<Weight>::MakeTree(VertexId from, Workspace& workspace) const {
+    router_.BuildTree(from, workspace);
+    const size_t vertex_count = graph_.GetVertexCount();
+    auto tree = std::make_shared<Tree>();
+    tree->weights.resize(vertex_count, INFINITE_WEIGHT);
+    tree->prev_edges.resize(vertex_count, NO_EDGE);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        if (workspace.IsReached(vertex)) {
+            tree->weights[vertex] = workspace.GetWeight(vertex);
+            tree->prev_edges[vertex] = static_cast<uint32_t>(workspace.GetPrevEdge(vertex));
+        }
+    }
+    return tree;
+}
+
+template <typename Weight>
+std::shared_ptr<const typename ShortestPathTreeCache<Weight>::Tree> ShortestPathTreeCache<Weight>::GetTree(VertexId from, Workspace& workspace) {
+    if (from >= graph_.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    {
+        std::lock_guard lock(mutex_);
+        if (const auto it = index_.find(from); it != index_.end()) {
+            ++stats_.hit_count;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+        ++stats_.miss_count;
+    }
+
+    auto tree = MakeTree(from, workspace);
+
+    std::lock_guard lock(mutex_);
+    stats_.settled_vertex_count += workspace.GetSettledCount();
+    //то же дерево мог уже добавить другой поток
+    if (const auto it = index_.find(from); it != index_.end()) {
+        return it->second->second;
+    }
+    if (entries_.size() == capacity_) {
+        const Entry& evicted = entries_.back();
+        stats_.memory_bytes -= sizeof(Tree) + evicted.second->weights.size() * (sizeof(Weight) + sizeof(uint32_t));
+        index_.erase(evicted.first);
+        entries_.pop_back();
+        ++stats_.eviction_count;
+    }
+    entries_.emplace_front(from, tree);
+    index_[from] = entries_.begin();
+    stats_.memory_bytes += sizeof(Tree) + tree->weights.size() * (sizeof(Weight) + sizeof(uint32_t));
+    return tree;
+}
+
+template <typename Weight>
+std::optional<typename ShortestPathTreeCache<Weight>::RouteInfo> ShortestPathTreeCache<Weight>::BuildRoute(VertexId from, VertexId to, Workspace& workspace) {
+    if (to >= graph_.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    const auto tree = GetTree(from, workspace);
+    if (!tree->IsReached(to)) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (uint32_t edge_id = tree->prev_edges[to];
+         edge_id != NO_EDGE;
+         edge_id = tree->prev_edges[graph_.GetEdgeSource(edge_id)])
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{tree->weights[to], std::move(edges)};
+}
+
+template <typename Weight>
+typename ShortestPathTreeCache<Weight>::Stats ShortestPathTreeCache<Weight>::GetStats() const {
+    std::lock_guard lock(mutex_);
+    Stats stats = stats_;
+    stats.tree_count = entries_.size();
+    return stats;
+}
+
+}  // namespace graph
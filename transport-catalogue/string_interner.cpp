@@ -0,0 +1,31 @@
+#include "string_interner.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace catalogue {
+
+std::string_view StringInterner::Intern(std::string_view str) {
+    if (const auto it = strings_.find(str); it != strings_.end()) {
+        return *it;
+    }
+    if (str.size() > free_size_ || !free_begin_) {
+        //длинная строка получает собственный блок, остаток текущего блока не теряется
+        const size_t block_size = std::max(str.size(), BLOCK_SIZE);
+        blocks_.push_back(std::make_unique<char[]>(block_size));
+        memory_bytes_ += block_size;
+        if (block_size == str.size()) {
+            std::memcpy(blocks_.back().get(), str.data(), str.size());
+            return *strings_.insert({blocks_.back().get(), str.size()}).first;
+        }
+        free_begin_ = blocks_.back().get();
+        free_size_ = block_size;
+    }
+    std::memcpy(free_begin_, str.data(), str.size());
+    const std::string_view result(free_begin_, str.size());
+    free_begin_ += str.size();
+    free_size_ -= str.size();
+    return *strings_.insert(result).first;
+}
+
+} // namespace catalogue
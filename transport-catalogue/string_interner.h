@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace catalogue {
+
+// Хранилище названий: каждая строка хранится один раз в общих блоках памяти,
+// а наружу выдаются string_view, действительные всё время жизни хранилища.
+// Названия остановок и маршрутов в справочнике, рёбрах графа и индексах указывают сюда
+class StringInterner {
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // возвращает сохранённую копию str; одинаковые строки сохраняются один раз
+    std::string_view Intern(std::string_view str);
+
+    // число различных строк
+    size_t GetSize() const {
+        return strings_.size();
+    }
+
+    // память, занятая блоками строк
+    size_t GetMemoryBytes() const {
+        return memory_bytes_;
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    // свободное место в последнем блоке
+    char* free_begin_ = nullptr;
+    size_t free_size_ = 0;
+    size_t memory_bytes_ = 0;
+    std::unordered_set<std::string_view> strings_;
+};
+
+} // namespace catalogue
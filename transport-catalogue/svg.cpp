@@ -171,12 +171,24 @@ void Document::AddPtr(std::unique_ptr<Object>&& obj) {
 }
 
 void Document::Render(std::ostream& out) const {
-    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"sv << std::endl;
-    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">"sv << std::endl;
+    RenderBegin(out);
+    RenderObjects(out);
+    RenderEnd(out);
+}
+
+void Document::RenderObjects(std::ostream& out) const {
     RenderContext context{out, 2, 2};
     for (const auto& obj : objects_) {
         obj->Render(context);
     }
+}
+
+void Document::RenderBegin(std::ostream& out) {
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"sv << std::endl;
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">"sv << std::endl;
+}
+
+void Document::RenderEnd(std::ostream& out) {
     out << "</svg>"sv;
 }
     
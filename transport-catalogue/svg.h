@@ -317,6 +317,12 @@ public:
 
     // Выводит в ostream svg-представление документа
     void Render(std::ostream& out) const;
+
+    // Выводит только объекты документа, без заголовка и закрывающего тега,
+    // чтобы части одного изображения можно было выводить независимо и затем склеить
+    void RenderObjects(std::ostream& out) const;
+    static void RenderBegin(std::ostream& out);
+    static void RenderEnd(std::ostream& out);
     
     // Прочие методы и данные, необходимые для реализации класса Document
 private:
@@ -0,0 +1,219 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+namespace scheduling {
+
+namespace {
+
+//поток планировщика, выполняющий текущую задачу
+struct CurrentWorker {
+    const TaskScheduler* scheduler = nullptr;
+    size_t worker = 0;
+};
+
+thread_local CurrentWorker current_worker;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t worker_count)
+    : worker_count_(worker_count != 0 ? worker_count : std::max(1u, std::thread::hardware_concurrency())) {
+    workers_.reserve(worker_count_);
+    for (size_t i = 0; i < worker_count_; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+void TaskScheduler::WakeUp(bool all) {
+    //захват мьютекса не даёт уведомлению проскочить между проверкой условия и засыпанием
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    if (all) {
+        wake_up_.notify_all();
+    } else {
+        wake_up_.notify_one();
+    }
+}
+
+void TaskScheduler::Push(size_t worker, Task task) {
+    ++pending_;
+    {
+        std::lock_guard lock(workers_[worker]->mutex);
+        workers_[worker]->tasks.push_back(std::move(task));
+    }
+    ++queued_;
+    WakeUp(false);
+}
+
+bool TaskScheduler::PopOwn(size_t worker, Task& task) {
+    std::lock_guard lock(workers_[worker]->mutex);
+    auto& tasks = workers_[worker]->tasks;
+    if (tasks.empty()) {
+        return false;
+    }
+    task = std::move(tasks.back());
+    tasks.pop_back();
+    --queued_;
+    return true;
+}
+
+bool TaskScheduler::Steal(size_t worker, Task& task) {
+    for (size_t shift = 1; shift < worker_count_; ++shift) {
+        Worker& victim = *workers_[(worker + shift) % worker_count_];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::Execute(Task& task) {
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard lock(error_mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+        failed_ = true;
+    }
+    if (--pending_ == 0) {
+        WakeUp(true);
+    }
+}
+
+void TaskScheduler::RethrowError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(error_mutex_);
+        error = error_;
+    }
+    std::rethrow_exception(error);
+}
+
+bool TaskScheduler::RunOne(size_t worker) {
+    Task task;
+    if (!PopOwn(worker, task) && !Steal(worker, task)) {
+        return false;
+    }
+    Execute(task);
+    return true;
+}
+
+void TaskScheduler::WorkerLoop(size_t worker) {
+    current_worker = {this, worker};
+    while (pending_ > 0) {
+        if (!RunOne(worker)) {
+            std::unique_lock lock(sleep_mutex_);
+            wake_up_.wait(lock, [this] {
+                return pending_ == 0 || queued_ > 0;
+            });
+        }
+    }
+    current_worker = {};
+}
+
+void TaskScheduler::Run(std::vector<WeightedTask> tasks) {
+    //в одном потоке задачи выполняются в исходном порядке
+    if (worker_count_ == 1) {
+        for (auto& weighted_task : tasks) {
+            weighted_task.task();
+        }
+        return;
+    }
+
+    std::vector<size_t> order(tasks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&tasks](size_t lhs, size_t rhs) {
+        return tasks[lhs].cost > tasks[rhs].cost;
+    });
+    std::vector<size_t> loads(worker_count_, 0);
+    std::vector<std::vector<size_t>> assigned(worker_count_);
+    for (const size_t index : order) {
+        const size_t worker = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        loads[worker] += tasks[index].cost;
+        assigned[worker].push_back(index);
+    }
+    //владелец берёт задачи с конца очереди, поэтому самые дорогие кладутся последними
+    for (size_t worker = 0; worker < worker_count_; ++worker) {
+        for (auto it = assigned[worker].rbegin(); it != assigned[worker].rend(); ++it) {
+            Push(worker, [this, task = std::move(tasks[*it].task)] {
+                if (!failed_) {
+                    task();
+                }
+            });
+        }
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(worker_count_ - 1);
+    for (size_t worker = 1; worker < worker_count_; ++worker) {
+        threads.emplace_back([this, worker] {
+            WorkerLoop(worker);
+        });
+    }
+    WorkerLoop(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(error_mutex_);
+        std::swap(error, error_);
+    }
+    failed_ = false;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskScheduler::RunAndWait(std::vector<Task> subtasks) {
+    if (current_worker.scheduler != this) {
+        for (auto& subtask : subtasks) {
+            subtask();
+        }
+        return;
+    }
+
+    const size_t worker = current_worker.worker;
+    std::atomic<size_t> remaining{subtasks.size()};
+    for (auto& subtask : subtasks) {
+        Push(worker, [this, &remaining, subtask = std::move(subtask)] {
+            //счётчик уменьшается и при исключении или пропуске подзадачи, чтобы ожидающий поток не завис
+            struct Done {
+                TaskScheduler& scheduler;
+                std::atomic<size_t>& remaining;
+                ~Done() {
+                    if (--remaining == 0) {
+                        scheduler.WakeUp(true);
+                    }
+                }
+            } done{*this, remaining};
+            if (!failed_) {
+                subtask();
+            }
+        });
+    }
+    while (remaining > 0) {
+        if (!RunOne(worker)) {
+            std::unique_lock lock(sleep_mutex_);
+            wake_up_.wait(lock, [this, &remaining] {
+                return remaining == 0 || queued_ > 0;
+            });
+        }
+    }
+    //результаты подзадач неполны, поэтому задача прерывается тем же исключением
+    if (failed_) {
+        RethrowError();
+    }
+}
+
+} // namespace scheduling
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace scheduling {
+
+// Планировщик задач с захватом работы (work stealing).
+// У каждого потока своя двусторонняя очередь: владелец берёт задачи с конца,
+// а освободившиеся потоки забирают их с начала чужих очередей. Поэтому поток,
+// получивший тяжёлую задачу, не задерживает остальные: лёгкие задачи из его очереди
+// выполняют другие. Задача может разбить себя на подзадачи через RunAndWait.
+// Потоки без работы засыпают до появления задач в очередях
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    // задача и оценка её стоимости в условных единицах
+    struct WeightedTask {
+        Task task;
+        size_t cost = 1;
+    };
+
+    // worker_count - число потоков, включая вызывающий Run (0 - по числу ядер)
+    explicit TaskScheduler(size_t worker_count = 1);
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Выполняет задачи и все порождённые ими подзадачи, возвращается после завершения всех.
+    // Задачи раздаются по очередям потоков от самых дорогих к самым дешёвым,
+    // каждая - в очередь с наименьшей суммарной стоимостью.
+    // После первого исключения ещё не начатые задачи и подзадачи не выполняются,
+    // а само исключение пробрасывается после остановки потоков
+    void Run(std::vector<WeightedTask> tasks);
+
+    // Выполняет подзадачи и дожидается их. Внутри Run подзадачи попадают в очередь
+    // текущего потока, где их могут забрать другие, а ожидающий поток сам выполняет задачи;
+    // вне Run подзадачи выполняются по очереди в вызывающем потоке.
+    // Если какая-либо задача Run завершилась исключением, RunAndWait пробрасывает его
+    void RunAndWait(std::vector<Task> subtasks);
+
+    size_t GetWorkerCount() const {
+        return worker_count_;
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Push(size_t worker, Task task);
+    bool PopOwn(size_t worker, Task& task);
+    bool Steal(size_t worker, Task& task);
+    // выполняет одну задачу из своей или чужой очереди, false - задач не нашлось
+    bool RunOne(size_t worker);
+    void WorkerLoop(size_t worker);
+    void Execute(Task& task);
+    // будит спящие потоки после изменения queued_, pending_ или счётчика подзадач
+    void WakeUp(bool all);
+    void RethrowError();
+
+    size_t worker_count_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    // задачи, поставленные в очереди и ещё не выполненные
+    std::atomic<size_t> pending_{0};
+    // задачи, лежащие в очередях (ещё не взятые потоками)
+    std::atomic<size_t> queued_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+    // задача завершилась исключением: остальные задачи пропускаются
+    std::atomic<bool> failed_{false};
+};
+
+} // namespace scheduling
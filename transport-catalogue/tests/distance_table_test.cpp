@@ -0,0 +1,147 @@
+// Проверка catalogue::DistanceTable и сравнение скорости поиска с unordered_map.
+// Сборка из каталога transport-catalogue:
+//     g++ -std=c++17 -O2 -I. tests/distance_table_test.cpp distance_table.cpp -o distance_table_test
+
+#include "distance_table.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using catalogue::DistanceTable;
+using StopPair = std::pair<uint32_t, uint32_t>;
+
+// расстояние так, как его отдавал справочник до DistanceTable: прямое, иначе обратное, иначе 0
+template <typename Map>
+int GetReference(const Map& distances, uint32_t from, uint32_t to) {
+    if (const auto it = distances.find({from, to}); it != distances.end()) {
+        return it->second;
+    }
+    if (const auto it = distances.find({to, from}); it != distances.end()) {
+        return it->second;
+    }
+    return 0;
+}
+
+void TestEmpty() {
+    const DistanceTable table;
+    assert(table.Get(0, 0) == 0);
+    assert(table.Get(1, 2) == 0);
+    assert(table.GetSize() == 0);
+}
+
+void TestDirections() {
+    DistanceTable table;
+    table.Set(3, 7, 100);
+    //обратное направление не задано - берётся прямое
+    assert(table.Get(3, 7) == 100);
+    assert(table.Get(7, 3) == 100);
+    table.Set(7, 3, 250);
+    assert(table.Get(3, 7) == 100);
+    assert(table.Get(7, 3) == 250);
+    //повторное задание заменяет расстояние, а пара занимает одну ячейку
+    table.Set(3, 7, 120);
+    assert(table.Get(3, 7) == 120);
+    assert(table.GetSize() == 1);
+    //расстояние от остановки до неё самой и нулевое расстояние
+    table.Set(5, 5, 40);
+    table.Set(1, 2, 0);
+    assert(table.Get(5, 5) == 40);
+    assert(table.Get(2, 1) == 0);
+    assert(table.Get(3, 8) == 0);
+    assert(table.GetSize() == 3);
+}
+
+// случайные расстояния, в том числе повторные и в обе стороны; таблица растёт много раз
+void TestMatchesReference() {
+    std::mt19937 generator(21);
+    std::uniform_int_distribution<uint32_t> stop(0, 3000);
+    std::uniform_int_distribution<int> distance(0, 100000);
+    DistanceTable table;
+    std::map<StopPair, int> reference;
+    for (int i = 0; i < 50000; ++i) {
+        const uint32_t from = stop(generator);
+        const uint32_t to = stop(generator);
+        const int value = distance(generator);
+        table.Set(from, to, value);
+        reference[{from, to}] = value;
+    }
+    std::map<StopPair, bool> pairs;
+    for (const auto& [stops, value] : reference) {
+        pairs[{std::min(stops.first, stops.second), std::max(stops.first, stops.second)}] = true;
+        assert(table.Get(stops.first, stops.second) == value);
+        assert(table.Get(stops.second, stops.first) == GetReference(reference, stops.second, stops.first));
+    }
+    assert(table.GetSize() == pairs.size());
+    for (int i = 0; i < 100000; ++i) {
+        const uint32_t from = stop(generator);
+        const uint32_t to = stop(generator);
+        assert(table.Get(from, to) == GetReference(reference, from, to));
+    }
+}
+
+// хеш пары, которым пользовался справочник до DistanceTable
+struct StopPairHasher {
+    size_t operator()(const StopPair& stops) const {
+        return std::hash<uint32_t>{}(stops.first) + std::hash<uint32_t>{}(stops.second) * 37;
+    }
+};
+
+// 20 тысяч остановок, 200 тысяч расстояний, 2 миллиона поисков, половина - в обратную сторону
+void BenchmarkLookups() {
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<uint32_t> stop(0, 19999);
+    std::vector<StopPair> stops;
+    DistanceTable table;
+    std::unordered_map<StopPair, int, StopPairHasher> map;
+    for (int i = 0; i < 200000; ++i) {
+        const StopPair pair{stop(generator), stop(generator)};
+        stops.push_back(pair);
+        table.Set(pair.first, pair.second, i);
+        map[pair] = i;
+    }
+    std::vector<StopPair> queries;
+    for (int i = 0; i < 2000000; ++i) {
+        const StopPair& pair = stops[generator() % stops.size()];
+        queries.push_back(i % 2 ? StopPair{pair.second, pair.first} : pair);
+    }
+
+    long long map_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& [from, to] : queries) {
+        map_sum += GetReference(map, from, to);
+    }
+    const auto map_time = std::chrono::steady_clock::now() - start;
+
+    long long table_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& [from, to] : queries) {
+        table_sum += table.Get(from, to);
+    }
+    const auto table_time = std::chrono::steady_clock::now() - start;
+
+    assert(map_sum == table_sum);
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    std::cout << "2M lookups: unordered_map " << duration_cast<milliseconds>(map_time).count() << " ms, DistanceTable "
+              << duration_cast<milliseconds>(table_time).count() << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    TestEmpty();
+    TestDirections();
+    TestMatchesReference();
+    BenchmarkLookups();
+    std::cout << "distance_table_test: OK" << std::endl;
+}
@@ -0,0 +1,226 @@
+// Проверка геометрических функций geo.h.
+// Сборка из каталога transport-catalogue:
+//     g++ -std=c++17 -O2 -I. tests/geo_test.cpp geo.cpp -o geo_test
+
+#define _USE_MATH_DEFINES
+#include "geo.h"
+
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// исходная формула ComputeDistance: синусы и косинусы широт на каждый отрезок
+double ComputeDistanceReference(geo::Coordinates from, geo::Coordinates to) {
+    using namespace std;
+    const double dr = M_PI / 180.0;
+    return acos(sin(from.lat * dr) * sin(to.lat * dr)
+                + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
+        * 6371000;
+}
+
+const double dr = M_PI / 180.0;
+const double earth_radius = 6371000;
+
+// расстояние по большому кругу по формуле гаверсинусов: в отличие от acos точно и на коротких отрезках
+double ComputeHaversineDistance(geo::Coordinates from, geo::Coordinates to) {
+    using namespace std;
+    const double sin_lat = sin((to.lat - from.lat) * dr / 2);
+    const double sin_lng = sin((to.lng - from.lng) * dr / 2);
+    const double h = sin_lat * sin_lat + cos(from.lat * dr) * cos(to.lat * dr) * sin_lng * sin_lng;
+    return 2 * earth_radius * asin(sqrt(h));
+}
+
+// точка на расстоянии distance метров от point по азимуту bearing (в радианах)
+geo::Coordinates MovePoint(geo::Coordinates point, double bearing, double distance) {
+    using namespace std;
+    const double lat = point.lat * dr;
+    const double angle = distance / earth_radius;
+    const double to_lat = asin(sin(lat) * cos(angle) + cos(lat) * sin(angle) * cos(bearing));
+    double to_lng = point.lng + atan2(sin(bearing) * sin(angle) * cos(lat), cos(angle) - sin(lat) * sin(to_lat)) / dr;
+    if (to_lng > 180.0) {
+        to_lng -= 360.0;
+    } else if (to_lng < -180.0) {
+        to_lng += 360.0;
+    }
+    return {to_lat / dr, to_lng};
+}
+
+bool IsBitIdentical(double lhs, double rhs) {
+    return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+// точки маршрутов внутри города и по всему шару
+std::vector<geo::Coordinates> MakeRandomPoints(std::mt19937& generator, size_t count) {
+    std::uniform_real_distribution<double> city_lat(55.5, 55.9);
+    std::uniform_real_distribution<double> city_lng(37.3, 37.9);
+    std::uniform_real_distribution<double> lat(-89.0, 89.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::vector<geo::Coordinates> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(i % 4 == 3 ? geo::Coordinates{lat(generator), lng(generator)}
+                                    : geo::Coordinates{city_lat(generator), city_lng(generator)});
+    }
+    return points;
+}
+
+// подготовленные точки и пакетный расчёт совпадают с исходной формулой бит в бит,
+// включая совпадающие точки и повтор остановки
+void TestPreparedPointsMatchReference() {
+    std::mt19937 generator(24);
+    std::vector<geo::Coordinates> points = MakeRandomPoints(generator, 100000);
+    points[10] = points[11];
+    std::vector<geo::PreparedPoint> prepared;
+    for (const auto& point : points) {
+        prepared.push_back(geo::PreparePoint(point));
+    }
+    std::vector<double> lengths(points.size() - 1);
+    geo::ComputeDistances(prepared.data(), prepared.size(), lengths.data());
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        const double expected = ComputeDistanceReference(points[i], points[i + 1]);
+        assert(IsBitIdentical(geo::ComputeDistance(points[i], points[i + 1]), expected));
+        assert(IsBitIdentical(geo::ComputeDistance(prepared[i], prepared[i + 1]), expected));
+        assert(IsBitIdentical(lengths[i], expected));
+    }
+    //ломаная из одной точки не имеет отрезков
+    geo::ComputeDistances(prepared.data(), 1, lengths.data());
+}
+
+// Погрешности из geo.h: равнопромежуточное приближение на отрезках не длиннее max_length
+// при |lat| <= 70°, в том числе через 180-й меридиан
+void TestEquirectangularErrorBound(double max_length, double max_error) {
+    std::mt19937 generator(25);
+    std::uniform_real_distribution<double> lat(-70.0, 70.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double worst_error = 0.0;
+    for (int i = 0; i < 200000; ++i) {
+        const geo::Coordinates from{lat(generator), lng(generator)};
+        const geo::Coordinates to = MovePoint(from, 2 * M_PI * unit(generator), max_length * unit(generator));
+        const double exact = ComputeHaversineDistance(from, to);
+        if (std::abs(to.lat) > 70.0 || exact < 1.0) {
+            continue;
+        }
+        worst_error = std::max(worst_error, std::abs(geo::ComputeEquirectangularDistance(from, to) - exact) / exact);
+    }
+    assert(worst_error <= max_error);
+    std::cout << "equirectangular, segments up to " << max_length / 1000 << " km: max error " << worst_error << std::endl;
+}
+
+// плоская проекция: обе точки не дальше max_offset от точки на опорной широте, |lat| <= 70°
+void TestFlatEarthErrorBound(double max_offset, double max_error) {
+    std::mt19937 generator(25);
+    std::uniform_real_distribution<double> lat(-70.0, 70.0);
+    std::uniform_real_distribution<double> lng(-180.0, 180.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double worst_error = 0.0;
+    for (int i = 0; i < 200000; ++i) {
+        const geo::Coordinates reference{lat(generator), lng(generator)};
+        const geo::FlatEarthProjection projection(reference.lat);
+        const geo::Coordinates from = MovePoint(reference, 2 * M_PI * unit(generator), max_offset * std::sqrt(unit(generator)));
+        const geo::Coordinates to = MovePoint(reference, 2 * M_PI * unit(generator), max_offset * std::sqrt(unit(generator)));
+        const double exact = ComputeHaversineDistance(from, to);
+        if (std::abs(from.lat) > 70.0 || std::abs(to.lat) > 70.0 || exact < 1.0) {
+            continue;
+        }
+        worst_error = std::max(worst_error, std::abs(projection.ComputeDistance(from, to) - exact) / exact);
+    }
+    assert(worst_error <= max_error);
+    std::cout << "flat earth, points within " << max_offset / 1000 << " km: max error " << worst_error << std::endl;
+}
+
+// длины маршрутов по исходной формуле и пакетным расчётом по подготовленным точкам
+void BenchmarkRouteLengths() {
+    std::mt19937 generator(7);
+    const std::vector<geo::Coordinates> points = MakeRandomPoints(generator, 2000000);
+    std::vector<geo::PreparedPoint> prepared;
+    for (const auto& point : points) {
+        prepared.push_back(geo::PreparePoint(point));
+    }
+
+    double reference_sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        reference_sum += ComputeDistanceReference(points[i], points[i + 1]);
+    }
+    const auto reference_time = std::chrono::steady_clock::now() - start;
+
+    double batch_sum = 0.0;
+    std::vector<double> lengths(points.size() - 1);
+    start = std::chrono::steady_clock::now();
+    geo::ComputeDistances(prepared.data(), prepared.size(), lengths.data());
+    for (const double length : lengths) {
+        batch_sum += length;
+    }
+    const auto batch_time = std::chrono::steady_clock::now() - start;
+
+    assert(IsBitIdentical(reference_sum, batch_sum));
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    std::cout << "2M segments: per-segment formula " << duration_cast<milliseconds>(reference_time).count()
+              << " ms, ComputeDistances " << duration_cast<milliseconds>(batch_time).count() << " ms" << std::endl;
+}
+
+// модели расстояния на одних и тех же отрезках внутри города; суммы длин сверяются,
+// чтобы циклы не были выброшены оптимизатором
+void BenchmarkDistanceModels() {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> lat(55.55, 55.85);
+    std::uniform_real_distribution<double> lng(37.35, 37.85);
+    std::vector<geo::Coordinates> points;
+    for (int i = 0; i < 2000000; ++i) {
+        points.push_back({lat(generator), lng(generator)});
+    }
+    const geo::FlatEarthProjection projection(55.7);
+
+    double great_circle_sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        great_circle_sum += geo::ComputeDistance(points[i], points[i + 1]);
+    }
+    const auto great_circle_time = std::chrono::steady_clock::now() - start;
+
+    double equirectangular_sum = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        equirectangular_sum += geo::ComputeEquirectangularDistance(points[i], points[i + 1]);
+    }
+    const auto equirectangular_time = std::chrono::steady_clock::now() - start;
+
+    double flat_earth_sum = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        flat_earth_sum += projection.ComputeDistance(points[i], points[i + 1]);
+    }
+    const auto flat_earth_time = std::chrono::steady_clock::now() - start;
+
+    //точки не дальше 17 км от опорной широты, отрезки короче 50 км: суммы в пределах погрешностей из geo.h
+    assert(great_circle_sum > 0.0);
+    assert(std::abs(equirectangular_sum - great_circle_sum) <= 3e-5 * great_circle_sum);
+    assert(std::abs(flat_earth_sum - great_circle_sum) <= 0.025 * great_circle_sum);
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    std::cout << "2M segments: ComputeDistance " << duration_cast<milliseconds>(great_circle_time).count()
+              << " ms, ComputeEquirectangularDistance " << duration_cast<milliseconds>(equirectangular_time).count()
+              << " ms, FlatEarthProjection " << duration_cast<milliseconds>(flat_earth_time).count() << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    TestPreparedPointsMatchReference();
+    TestEquirectangularErrorBound(10000, 1e-6);
+    TestEquirectangularErrorBound(50000, 3e-5);
+    TestEquirectangularErrorBound(100000, 1e-4);
+    TestFlatEarthErrorBound(10000, 0.005);
+    TestFlatEarthErrorBound(50000, 0.025);
+    BenchmarkRouteLengths();
+    BenchmarkDistanceModels();
+    std::cout << "geo_test: OK" << std::endl;
+}
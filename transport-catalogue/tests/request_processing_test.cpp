@@ -0,0 +1,132 @@
+// Проверка параллельной обработки stat_requests: ответы при нескольких потоках
+// совпадают с ответами в одном потоке, и замер времени обработки.
+// Сборка из каталога transport-catalogue:
+//     g++ -std=c++17 -O2 -pthread -I. tests/request_processing_test.cpp $(ls *.cpp | grep -v main.cpp) -o request_processing_test
+
+#include "json_reader.h"
+#include "request_handler.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// случайная сеть остановок и маршрутов и запросы всех видов, кроме статистики маршрутизатора:
+// её ответы зависят от порядка выполнения запросов. Кэш деревьев кратчайших путей маленький,
+// чтобы потоки вытесняли деревья друг друга
+std::string MakeInput(size_t stop_count, size_t bus_count, size_t request_count, std::string_view routing_mode,
+                      size_t thread_count) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> stop(0, stop_count - 1);
+    std::uniform_real_distribution<double> shift(0.0, 0.2);
+    std::uniform_int_distribution<int> distance(500, 5000);
+    std::vector<std::vector<size_t>> routes(bus_count);
+    //дорожные расстояния задаются для соседних остановок маршрутов
+    std::vector<std::vector<size_t>> neighbours(stop_count);
+    for (auto& route : routes) {
+        for (size_t j = 0; j < 8; ++j) {
+            route.push_back(stop(generator));
+            if (j > 0) {
+                neighbours[route[j - 1]].push_back(route[j]);
+            }
+        }
+    }
+    std::ostringstream input;
+    input << R"({"base_requests": [)";
+    for (size_t i = 0; i < stop_count; ++i) {
+        input << (i ? "," : "") << R"({"type": "Stop", "name": "Stop )" << i << R"(", "latitude": )" << 55.5 + shift(generator)
+              << R"(, "longitude": )" << 37.5 + shift(generator) << R"(, "road_distances": {)";
+        for (size_t j = 0; j < neighbours[i].size(); ++j) {
+            input << (j ? "," : "") << R"("Stop )" << neighbours[i][j] << R"(": )" << distance(generator);
+        }
+        input << "}}";
+    }
+    for (size_t i = 0; i < bus_count; ++i) {
+        input << R"(, {"type": "Bus", "name": "Bus )" << i << R"(", "is_roundtrip": false, "stops": [)";
+        for (size_t j = 0; j < routes[i].size(); ++j) {
+            input << (j ? "," : "") << R"("Stop )" << routes[i][j] << '"';
+        }
+        input << "]}";
+    }
+    input << R"(], "render_settings": {"width": 1200, "height": 800, "padding": 50, "stop_radius": 3, "line_width": 10,)"
+          << R"( "bus_label_font_size": 20, "bus_label_offset": [7, 15], "stop_label_font_size": 14, "stop_label_offset": [7, -3],)"
+          << R"( "underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3, "color_palette": ["green", [255, 160, 0], "red"]},)"
+          << R"( "routing_settings": {"bus_wait_time": 2, "bus_velocity": 40, "tree_cache_size": 8, "routing_mode": ")"
+          << routing_mode << R"("},)"
+          << R"( "request_processing_settings": {"threads": )" << thread_count << "},"
+          << R"( "stat_requests": [)";
+    for (size_t i = 0; i < request_count; ++i) {
+        input << (i ? "," : "") << R"({"id": )" << i;
+        switch (i % 10) {
+            case 0:
+                input << R"(, "type": "Bus", "name": "Bus )" << stop(generator) % bus_count << R"("})";
+                break;
+            case 1:
+                input << R"(, "type": "Stop", "name": "Stop )" << stop(generator) << R"("})";
+                break;
+            case 2:
+                input << (i % 100 == 2 ? R"(, "type": "Map"})" : R"(, "type": "Stop", "name": "Stop 0"})");
+                break;
+            case 3:
+                input << R"(, "type": "Matrix", "from": ["Stop )" << stop(generator) << R"(", "Stop )" << stop(generator)
+                      << R"("], "to": ["Stop )" << stop(generator) << R"(", "Stop )" << stop(generator) << R"(", "Stop )"
+                      << stop(generator) << R"("]})";
+                break;
+            case 4:
+                input << R"(, "type": "Isochrone", "from": "Stop )" << stop(generator) << R"(", "max_time": 30})";
+                break;
+            default:
+                input << R"(, "type": "Route", "from": "Stop )" << stop(generator) << R"(", "to": "Stop )" << stop(generator) << R"("})";
+        }
+    }
+    input << "]}";
+    return input.str();
+}
+
+// обрабатывает запросы так же, как main, и возвращает вывод
+std::string Process(const std::string& input_text, double& seconds) {
+    std::istringstream input(input_text);
+    catalogue::TransportCatalogue catalogue;
+    reader::JsonReader json_doc(input);
+    json_doc.ParseBaseRequests();
+    json_doc.ApplyCommands(catalogue);
+    const auto& stat_requests = json_doc.GetStatRequests();
+    const auto& renderer = json_doc.ParseRenderSettings(json_doc.GetRenderSettings().AsDict());
+    const auto& routing_settings = json_doc.FillRoutingSettings(json_doc.GetRoutingSettings());
+    const catalogue::TransportRouter router(routing_settings, catalogue);
+    RequestHandler rh(catalogue, renderer, router, json_doc.GetRequestThreadCount());
+
+    std::ostringstream output;
+    std::streambuf* cout_buffer = std::cout.rdbuf(output.rdbuf());
+    const auto start = std::chrono::steady_clock::now();
+    json_doc.ProcessRequests(stat_requests, rh);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(cout_buffer);
+    return output.str();
+}
+
+}  // namespace
+
+int main() {
+    //у каждого режима своё состояние запросов: таблица всех пар, рабочие области потоков, общий кэш деревьев
+    for (const std::string_view routing_mode : {"all_pairs", "dijkstra", "a_star", "raptor", "contraction_hierarchies",
+                                                "shortest_path_trees"}) {
+        double sequential_seconds = 0.0;
+        const std::string expected = Process(MakeInput(300, 50, 2000, routing_mode, 1), sequential_seconds);
+        std::cout << routing_mode << ", threads: 1, 2000 requests: " << sequential_seconds * 1000 << " ms" << std::endl;
+        for (const size_t thread_count : {2, 4, 8}) {
+            double seconds = 0.0;
+            const std::string output = Process(MakeInput(300, 50, 2000, routing_mode, thread_count), seconds);
+            assert(output == expected);
+            std::cout << routing_mode << ", threads: " << thread_count << ", 2000 requests: " << seconds * 1000 << " ms"
+                      << std::endl;
+        }
+    }
+    std::cout << "request_processing_test: OK" << std::endl;
+}
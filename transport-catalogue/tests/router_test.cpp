@@ -0,0 +1,207 @@
+// Проверка таблицы всех пар graph::Router на случайных графах.
+// Сборка из каталога transport-catalogue:
+//     g++ -std=c++17 -O2 -pthread -I. tests/router_test.cpp min_plus.cpp -o router_test
+
+#include "router.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Graph = graph::DirectedWeightedGraph<double>;
+
+// Исходная версия Router: Флойд - Уоршелл по таблице optional, эталон весов и выбора рёбер
+class ReferenceRouter {
+public:
+    explicit ReferenceRouter(const Graph& graph)
+        : graph_(graph)
+        , routes_(graph.GetVertexCount(), std::vector<std::optional<Data>>(graph.GetVertexCount())) {
+        const size_t vertex_count = graph.GetVertexCount();
+        for (graph::VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            routes_[vertex][vertex] = Data{0.0, std::nullopt};
+            for (const graph::EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto& edge = graph.GetEdge(edge_id);
+                auto& route = routes_[vertex][edge.to];
+                if (!route || route->weight > edge.weight) {
+                    route = Data{edge.weight, edge_id};
+                }
+            }
+        }
+        for (graph::VertexId through = 0; through < vertex_count; ++through) {
+            for (graph::VertexId from = 0; from < vertex_count; ++from) {
+                if (const auto route_from = routes_[from][through]) {
+                    for (graph::VertexId to = 0; to < vertex_count; ++to) {
+                        if (const auto& route_to = routes_[through][to]) {
+                            auto& route = routes_[from][to];
+                            const double candidate = route_from->weight + route_to->weight;
+                            if (!route || candidate < route->weight) {
+                                route = Data{candidate, route_to->prev_edge ? route_to->prev_edge : route_from->prev_edge};
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::optional<graph::Route<double>> BuildRoute(graph::VertexId from, graph::VertexId to) const {
+        const auto& route = routes_[from][to];
+        if (!route) {
+            return std::nullopt;
+        }
+        std::vector<graph::EdgeId> edges;
+        for (auto edge_id = route->prev_edge; edge_id; edge_id = routes_[from][graph_.GetEdge(*edge_id).from]->prev_edge) {
+            edges.push_back(*edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+        return graph::Route<double>{route->weight, std::move(edges)};
+    }
+
+private:
+    struct Data {
+        double weight;
+        std::optional<graph::EdgeId> prev_edge;
+    };
+
+    const Graph& graph_;
+    std::vector<std::vector<std::optional<Data>>> routes_;
+};
+
+// Граф с большой долей нулевых рёбер, в том числе с циклами нулевого веса и кратными рёбрами.
+// Ненулевые веса не представимы точно ни во float, ни в FixedPointMinutes
+Graph MakeRandomGraph(std::mt19937& generator, size_t vertex_count, size_t edge_count) {
+    Graph graph(vertex_count);
+    std::uniform_int_distribution<size_t> vertex(0, vertex_count - 1);
+    std::uniform_int_distribution<int> weight(0, 6);
+    for (size_t i = 0; i < edge_count; ++i) {
+        const int w = weight(generator);
+        graph.AddEdge({"", 0, vertex(generator), vertex(generator), w < 3 ? 0.0 : w * 1.37});
+    }
+    return graph;
+}
+
+// рёбра маршрута идут цепочкой from -> to, а сумма их весов равна весу маршрута
+void CheckRouteEdges(const Graph& graph, graph::VertexId from, graph::VertexId to, const graph::Route<double>& route,
+                     double tolerance) {
+    graph::VertexId vertex = from;
+    double weight = 0.0;
+    for (const graph::EdgeId edge_id : route.edges) {
+        const auto& edge = graph.GetEdge(edge_id);
+        assert(edge.from == vertex);
+        vertex = edge.to;
+        weight += edge.weight;
+    }
+    assert(vertex == to);
+    assert(std::abs(weight - route.weight) <= tolerance);
+}
+
+// таблица в double совпадает с эталоном побитно: и веса, и выбранные рёбра
+void TestMatchesReference(const Graph& graph, size_t thread_count) {
+    const ReferenceRouter reference(graph);
+    const graph::Router<double> router(graph, thread_count);
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto expected = reference.BuildRoute(from, to);
+            const auto route = router.BuildRoute(from, to);
+            assert(expected.has_value() == route.has_value());
+            if (route) {
+                assert(route->weight == expected->weight);
+                assert(route->edges == expected->edges);
+                CheckRouteEdges(graph, from, to, *route, 1e-9);
+            }
+        }
+    }
+}
+
+// в таблицах float и FixedPoint веса путей приближённые, но маршруты корректны,
+// а вес маршрута равен сумме весов его рёбер без округления
+template <typename TableWeight>
+void TestCompactTable(const Graph& graph, size_t thread_count, double tolerance) {
+    const ReferenceRouter reference(graph);
+    const graph::Router<double, TableWeight> router(graph, thread_count);
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto expected = reference.BuildRoute(from, to);
+            const auto route = router.BuildRoute(from, to);
+            assert(expected.has_value() == route.has_value());
+            if (route) {
+                assert(std::abs(route->weight - expected->weight) <= tolerance);
+                CheckRouteEdges(graph, from, to, *route, 0.0);
+            }
+        }
+    }
+}
+
+// таблица, записанная WriteTable и прочитанная обратно (как файл кэша), даёт те же маршруты
+template <typename TableWeight>
+void TestTableRoundTrip(const Graph& graph) {
+    const graph::Router<double, TableWeight> built(graph, 4);
+    std::ostringstream output;
+    built.WriteTable(output);
+    const auto table = std::make_shared<const std::string>(output.str());
+    assert(table->size() == built.GetTableSize());
+    const graph::Router<double, TableWeight> loaded(graph, table->data(), table->size(), table);
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const auto expected = built.BuildRoute(from, to);
+            const auto route = loaded.BuildRoute(from, to);
+            assert(expected.has_value() == route.has_value());
+            if (route) {
+                assert(route->weight == expected->weight);
+                assert(route->edges == expected->edges);
+            }
+        }
+    }
+}
+
+// испорченная таблица с циклом предыдущих рёбер не зацикливает BuildRoute
+void TestCyclicTableThrows() {
+    Graph graph(2);
+    graph.AddEdge({"", 0, 0, 1, 1.0});
+    graph.AddEdge({"", 0, 1, 0, 1.0});
+    const graph::Router<double> built(graph);
+    std::vector<char> table;
+    table.resize(built.GetTableSize());
+    const double weights[] = {0.0, 1.0, 1.0, 0.0};
+    const uint32_t prev_edges[] = {1, 0, 1, 0};
+    std::memcpy(table.data(), weights, sizeof(weights));
+    std::memcpy(table.data() + sizeof(weights), prev_edges, sizeof(prev_edges));
+    const graph::Router<double> router(graph, table.data(), table.size(), nullptr);
+    bool thrown = false;
+    try {
+        router.BuildRoute(0, 1);
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 generator(42);
+    for (int i = 0; i < 40; ++i) {
+        // больше 64 вершин, чтобы строки делились между несколькими задачами
+        const size_t vertex_count = i < 20 ? 12 : 150;
+        const Graph graph = MakeRandomGraph(generator, vertex_count, vertex_count * 3);
+        TestMatchesReference(graph, 1);
+        TestMatchesReference(graph, 4);
+        TestCompactTable<float>(graph, 4, 1e-3);
+        TestCompactTable<graph::FixedPointMinutes>(graph, 4, 1e-1);
+        TestTableRoundTrip<double>(graph);
+        TestTableRoundTrip<float>(graph);
+        TestTableRoundTrip<graph::FixedPointMinutes>(graph);
+    }
+    TestCyclicTableThrows();
+    std::cout << "router_test: OK" << std::endl;
+}
@@ -0,0 +1,152 @@
+// Проверка планировщика scheduling::TaskScheduler и замер его пропускной способности.
+// Сборка из каталога transport-catalogue:
+//     g++ -std=c++17 -O2 -pthread -I. tests/task_scheduler_test.cpp task_scheduler.cpp -o task_scheduler_test
+
+#include "task_scheduler.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using scheduling::TaskScheduler;
+
+// каждая задача и подзадача выполняется ровно один раз, в том числе при вложенных RunAndWait
+void TestAllTasksRunOnce(size_t worker_count) {
+    TaskScheduler scheduler(worker_count);
+    std::vector<std::atomic<int>> runs(100 * 10);
+    std::vector<TaskScheduler::WeightedTask> tasks;
+    for (size_t i = 0; i < 100; ++i) {
+        tasks.push_back({[&scheduler, &runs, i] {
+            std::vector<TaskScheduler::Task> subtasks;
+            for (size_t j = 0; j < 10; ++j) {
+                subtasks.push_back([&runs, i, j] {
+                    ++runs[i * 10 + j];
+                });
+            }
+            scheduler.RunAndWait(std::move(subtasks));
+            //после RunAndWait все подзадачи уже выполнены
+            for (size_t j = 0; j < 10; ++j) {
+                assert(runs[i * 10 + j] == 1);
+            }
+        }, i % 7 + 1});
+    }
+    scheduler.Run(std::move(tasks));
+    for (const auto& count : runs) {
+        assert(count == 1);
+    }
+}
+
+// после исключения оставшиеся задачи не выполняются, а исключение доходит до вызывающего Run
+void TestErrorAbandonsRemainingTasks(size_t worker_count) {
+    TaskScheduler scheduler(worker_count);
+    std::atomic<int> runs{0};
+    std::vector<TaskScheduler::WeightedTask> tasks;
+    //самая дорогая задача раздаётся первой и выполняется раньше остальных
+    tasks.push_back({[] {
+        throw std::runtime_error("task failed");
+    }, 1000});
+    for (int i = 0; i < 1000; ++i) {
+        tasks.push_back({[&runs] {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++runs;
+        }, 1});
+    }
+    bool thrown = false;
+    try {
+        scheduler.Run(std::move(tasks));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(runs < 1000);
+
+    //следующий запуск выполняет задачи как обычно
+    runs = 0;
+    std::vector<TaskScheduler::WeightedTask> next_tasks(10, {[&runs] {
+        ++runs;
+    }, 1});
+    scheduler.Run(std::move(next_tasks));
+    assert(runs == 10);
+}
+
+// исключение подзадачи прерывает ожидающую её задачу
+void TestSubtaskErrorStopsParent() {
+    TaskScheduler scheduler(2);
+    std::atomic<bool> parent_continued{false};
+    std::vector<TaskScheduler::WeightedTask> tasks;
+    tasks.push_back({[&scheduler, &parent_continued] {
+        std::vector<TaskScheduler::Task> subtasks;
+        subtasks.push_back([] {
+            throw std::runtime_error("subtask failed");
+        });
+        scheduler.RunAndWait(std::move(subtasks));
+        parent_continued = true;
+    }, 1});
+    bool thrown = false;
+    try {
+        scheduler.Run(std::move(tasks));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(!parent_continued);
+}
+
+// потоки без работы спят, а не крутятся: пока одна задача ждёт, процессорное время почти не тратится
+void TestIdleWorkersSleep() {
+    TaskScheduler scheduler(4);
+    std::vector<TaskScheduler::WeightedTask> tasks;
+    tasks.push_back({[] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }, 1});
+    const std::clock_t cpu_start = std::clock();
+    scheduler.Run(std::move(tasks));
+    const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    assert(cpu_seconds < 0.1);
+}
+
+// время выполнения множества мелких задач, каждая из которых порождает подзадачи
+void BenchmarkThroughput(size_t worker_count) {
+    TaskScheduler scheduler(worker_count);
+    std::atomic<size_t> sum{0};
+    std::vector<TaskScheduler::WeightedTask> tasks;
+    for (size_t i = 0; i < 20000; ++i) {
+        tasks.push_back({[&scheduler, &sum, i] {
+            std::vector<TaskScheduler::Task> subtasks(4, [&sum, i] {
+                size_t value = i;
+                for (int k = 0; k < 1000; ++k) {
+                    value = value * 6364136223846793005u + 1442695040888963407u;
+                }
+                sum += value & 1;
+            });
+            scheduler.RunAndWait(std::move(subtasks));
+        }, 1});
+    }
+    const auto start = std::chrono::steady_clock::now();
+    scheduler.Run(std::move(tasks));
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "workers: " << worker_count << ", 20000 tasks x 4 subtasks: " << elapsed.count() << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    for (const size_t worker_count : {1, 2, 4, 8}) {
+        TestAllTasksRunOnce(worker_count);
+    }
+    TestErrorAbandonsRemainingTasks(2);
+    TestErrorAbandonsRemainingTasks(4);
+    TestSubtaskErrorStopsParent();
+    TestIdleWorkersSleep();
+    for (const size_t worker_count : {1, 2, 4}) {
+        BenchmarkThroughput(worker_count);
+    }
+    std::cout << "task_scheduler_test: OK" << std::endl;
+}
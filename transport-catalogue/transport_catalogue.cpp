@@ -1,18 +1,39 @@
 #include "transport_catalogue.h"
 
-void catalogue::TransportCatalogue::AddStop(const Stop& stop){
-    stops_.push_back(stop);
-    stopname_to_stop_.insert({std::move(stops_.back().name), &stops_.back()});
+void catalogue::TransportCatalogue::AddStop(std::string_view name, geo::Coordinates coordinates){
+    const Stop& stop = stops_.emplace_back(Stop{&stop_columns_, stops_.size()});
+    stop_columns_.names.push_back(names_.Intern(name));
+    stop_columns_.latitudes.push_back(coordinates.lat);
+    stop_columns_.longitudes.push_back(coordinates.lng);
+    const geo::PreparedPoint point = geo::PreparePoint(coordinates);
+    stop_columns_.sin_latitudes.push_back(point.sin_lat);
+    stop_columns_.cos_latitudes.push_back(point.cos_lat);
+    if (stopname_to_stop_.insert({stop.GetName(), &stop}).second) {
+        sorted_stops_.push_back(&stop);
+    }
 }
 
-void catalogue::TransportCatalogue::AddBus(const Bus& bus){
-    buses_.push_back(bus);
-    busname_to_bus_.insert({std::move(buses_.back().number), &buses_.back()});
-    for (const Stop* stop : bus.route) {
-        if (stopname_to_stop_.count(stop->name)) {
-            buses_for_stop_[stopname_to_stop_[stop->name]].insert(&buses_.back());
-        }
-    }    
+void catalogue::TransportCatalogue::AddBus(std::string_view number, const std::vector<const Stop*>& route, bool is_circle){
+    Bus& bus = buses_.emplace_back();
+    bus.number = names_.Intern(number);
+    bus.route_offset = route_stops_.size();
+    bus.route_size = route.size();
+    bus.is_circle = is_circle;
+    for (const Stop* stop : route) {
+        route_stops_.push_back(static_cast<StopId>(stop->id));
+    }
+    if (busname_to_bus_.insert({bus.number, &bus}).second) {
+        sorted_buses_.push_back(&bus);
+    }
+}
+
+catalogue::RouteRange catalogue::TransportCatalogue::GetRoute(const Bus& bus) const {
+    const auto begin = route_stops_.begin() + bus.route_offset;
+    return RouteRange{begin, begin + bus.route_size};
+}
+
+const catalogue::Stop* catalogue::TransportCatalogue::GetStop(StopId id) const {
+    return &stops_[id];
 }
 
 const catalogue::Stop* catalogue::TransportCatalogue::FindStop(const std::string_view stop) const {
@@ -23,6 +44,10 @@ const catalogue::Stop* catalogue::TransportCatalogue::FindStop(const std::string
     return nullptr;
 }
 
+size_t catalogue::TransportCatalogue::GetStopCount() const {
+    return stops_.size();
+}
+
 const catalogue::Bus* catalogue::TransportCatalogue::FindBus(const std::string_view bus) const {
     auto it = busname_to_bus_.find(bus);
     if (it != busname_to_bus_.end()) {
@@ -31,97 +56,132 @@ const catalogue::Bus* catalogue::TransportCatalogue::FindBus(const std::string_v
     return nullptr;
 }
 
-const std::unordered_set<const catalogue::Bus*> catalogue::TransportCatalogue::FindBusesForStop(const std::string_view stop_name) const {
-    const Stop* stop_ptr = FindStop(stop_name);    
-    auto it = buses_for_stop_.find(stop_ptr);
-    if (it != buses_for_stop_.end()) {
-        return it->second;
+void catalogue::TransportCatalogue::SetDistanceModel(geo::DistanceModel model) {
+    distance_model_ = model;
+}
+
+void catalogue::TransportCatalogue::Finalize() {
+    //названия уникальны, поэтому порядок однозначен
+    std::sort(sorted_stops_.begin(), sorted_stops_.end(), [](const Stop* lhs, const Stop* rhs) {
+        return lhs->GetName() < rhs->GetName();
+    });
+    std::sort(sorted_buses_.begin(), sorted_buses_.end(), [](const Bus* lhs, const Bus* rhs) {
+        return lhs->number < rhs->number;
+    });
+    if (distance_model_ == geo::DistanceModel::FLAT_EARTH && !stop_columns_.latitudes.empty()) {
+        const auto [min_lat, max_lat] = std::minmax_element(stop_columns_.latitudes.begin(), stop_columns_.latitudes.end());
+        flat_earth_ = geo::FlatEarthProjection((*min_lat + *max_lat) / 2);
+    }
+    for (Bus& bus : buses_) {
+        bus.info = ComputeBusInfo(bus);
+    }
+    //автобусы остановки собираются по общему массиву остановок маршрутов
+    bus_names_for_stop_.assign(stops_.size(), {});
+    for (const Bus& bus : buses_) {
+        for (const StopId stop : GetRoute(bus)) {
+            bus_names_for_stop_[stop].push_back(bus.number);
+        }
+    }
+    for (auto& names : bus_names_for_stop_) {
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
     }
-    return {};
 }
 
-const catalogue::BusInfo catalogue::TransportCatalogue::GetBusInfo(const std::string_view bus_number) const {
-    catalogue::BusInfo bus_info{};
+const catalogue::BusInfo* catalogue::TransportCatalogue::GetBusInfo(const std::string_view bus_number) const {
     const catalogue::Bus* bus = FindBus(bus_number);
-    if (bus) {
-        {
-            if (bus->is_circle) {
-                bus_info.stops_count = bus->route.size();
+    return bus ? &bus->info : nullptr;
+}
+
+catalogue::BusInfo catalogue::TransportCatalogue::ComputeBusInfo(const Bus& bus) const {
+    catalogue::BusInfo bus_info{};
+    const RouteRange route = GetRoute(bus);
+    {
+        if (bus.is_circle) {
+            bus_info.stops_count = route.size();
+        } else {
+            bus_info.stops_count = route.size() * 2 - 1;            
+        }
+    }
+    {
+        std::vector<StopId> unique_stops(route.begin(), route.end());
+        std::sort(unique_stops.begin(), unique_stops.end());
+        bus_info.unique_stops_count = std::unique(unique_stops.begin(), unique_stops.end()) - unique_stops.begin();
+    }
+    {
+        int dist_length = 0;
+        double geo_length = 0.0;            
+        const std::vector<double> geo_distances = ComputeSegmentLengths(route);
+        for (std::size_t i = 1; i < route.size(); ++i) {
+            const StopId from = route[i - 1];
+            const StopId to = route[i];
+            if (bus.is_circle) {
+                dist_length += GetDistance(from, to);
+                geo_length += geo_distances[i - 1];
             } else {
-                bus_info.stops_count = bus->route.size() * 2 - 1;            
+                dist_length += GetDistance(from, to) + GetDistance(to, from);
+                geo_length += geo_distances[i - 1] * 2;
             }
         }
-        {
-            std::unordered_set<const Stop*> unique_stops;
-            const auto& route = FindBus(bus->number)->route;
-            for (const auto& stop : route) {
-                unique_stops.insert(stop);    
+        bus_info.dist_length = dist_length;
+        bus_info.geo_length = geo_length;
+        bus_info.curvature = dist_length / geo_length;
+    }       
+    return bus_info;
+}
+
+std::vector<double> catalogue::TransportCatalogue::ComputeSegmentLengths(RouteRange route) const {
+    std::vector<double> lengths(route.size() > 1 ? route.size() - 1 : 0);
+    switch (distance_model_) {
+        case geo::DistanceModel::GREAT_CIRCLE: {
+            //длины всех отрезков маршрута считаются одним проходом
+            std::vector<geo::PreparedPoint> points;
+            points.reserve(route.size());
+            for (const StopId stop : route) {
+                points.push_back(GetStopPoint(stop));
             }
-            bus_info.unique_stops_count = unique_stops.size();
+            geo::ComputeDistances(points.data(), points.size(), lengths.data());
+            break;
         }
-        {
-            int dist_length = 0;
-            double geo_length = 0.0;            
-            const auto& route = FindBus(bus->number)->route;   
-            for (std::size_t i = 1; i < route.size(); ++i) {
-                const catalogue::Stop* from = route[i - 1];
-                const catalogue::Stop* to = route[i];
-                if (bus->is_circle) {
-                    dist_length += GetDistance(from, to);
-                    geo_length += geo::ComputeDistance(from->coordinates, to->coordinates);
-                } else {
-                    dist_length += GetDistance(from, to) + GetDistance(to, from);
-                    geo_length += geo::ComputeDistance(from->coordinates, to->coordinates) * 2;
-                }
+        case geo::DistanceModel::EQUIRECTANGULAR:
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                lengths[i] = geo::ComputeEquirectangularDistance(GetStopCoordinates(route[i]), GetStopCoordinates(route[i + 1]));
+            }
+            break;
+        case geo::DistanceModel::FLAT_EARTH:
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                lengths[i] = flat_earth_.ComputeDistance(GetStopCoordinates(route[i]), GetStopCoordinates(route[i + 1]));
             }
-            bus_info.dist_length = dist_length;
-            bus_info.geo_length = geo_length;
-        }       
+            break;
     }
-    return bus_info;
+    return lengths;
 }
 
-const std::set<std::string_view> catalogue::TransportCatalogue::GetStopInfo(const std::string_view stop_name) const {
-    std::set<std::string_view> buses;  
+catalogue::TransportCatalogue::BusNamesRange catalogue::TransportCatalogue::GetStopInfo(const std::string_view stop_name) const {
     const Stop* stop_ptr = FindStop(stop_name);
-    if (stop_ptr) {
-        for (const auto& bus : FindBusesForStop(stop_name)) {
-            if (bus) {
-                buses.insert(std::move(bus->number));  
-            }
-        }
+    if (stop_ptr && stop_ptr->id < bus_names_for_stop_.size()) {
+        return ranges::AsRange(bus_names_for_stop_[stop_ptr->id]);
     }
-    return buses;
+    return BusNamesRange{{}, {}};
 }
 
 void catalogue::TransportCatalogue::SetDistance(const Stop* from, const Stop* to, const int dist) {
-    distances_[{from, to}] = dist;
+    if (from && to) {
+        distances_.Set(static_cast<uint32_t>(from->id), static_cast<uint32_t>(to->id), dist);
+    }
 }
 
 int catalogue::TransportCatalogue::GetDistance(const Stop* from, const Stop* to) const {
-    auto it = distances_.find({ from, to });
-    if (it != distances_.end()) {
-        return it->second;
+    if (!from || !to) {
+        return 0;
     }
-    it = distances_.find({ to, from });
-    if (it != distances_.end()) {
-        return it->second;
-    }
-    return 0;
+    return distances_.Get(static_cast<uint32_t>(from->id), static_cast<uint32_t>(to->id));
 }
 
-const std::map<std::string_view, const catalogue::Bus*> catalogue::TransportCatalogue::GetSortedAllBuses() const {
-    std::map<std::string_view, const Bus*> result;
-    for (const auto& bus : busname_to_bus_) {
-        result.emplace(bus);
-    }
-    return result;
+catalogue::BusRange catalogue::TransportCatalogue::GetSortedAllBuses() const {
+    return ranges::AsRange(sorted_buses_);
 }
 
-const std::map<std::string_view, const catalogue::Stop*> catalogue::TransportCatalogue::GetSortedAllStops() const {
-    std::map<std::string_view, const Stop*> result;
-    for (const auto& stop : stopname_to_stop_) {
-        result.emplace(stop);
-    }
-    return result;
+catalogue::StopRange catalogue::TransportCatalogue::GetSortedAllStops() const {
+    return ranges::AsRange(sorted_stops_);
 }
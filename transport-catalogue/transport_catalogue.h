@@ -6,68 +6,108 @@
 #include <string_view>
 #include <map>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <set>
 
 #include "geo.h"
 #include "domain.h"
+#include "distance_table.h"
+#include "string_interner.h"
+#include "ranges.h"
 
 namespace catalogue {
 
 class TransportCatalogue {
     public:
-    struct StopPairHasher {
-        
-        //хэшер для пары указателей на остановки         
-        std::size_t operator()(const std::pair<const Stop*, const Stop*>& p) const {                   
-        std::size_t hash1 = std::hash<const void*>{}(p.first);
-        std::size_t hash2 = std::hash<const void*>{}(p.second);
-            
-        //комбинируем хеши для обоих указателей            
-        return hash1 + hash2 * 37;                                                                     
-    }
-};    
-        void AddStop(const Stop& stop);
+        //добавляет остановку и присваивает ей следующий номер id
+        void AddStop(std::string_view name, geo::Coordinates coordinates);
         const Stop* FindStop(const std::string_view stop) const;            
-        void AddBus(const Bus& bus);                                        
+        size_t GetStopCount() const;
+        //остановка и её данные по номеру
+        const Stop* GetStop(StopId id) const;
+        std::string_view GetStopName(StopId id) const {
+            return stop_columns_.names[id];
+        }
+        geo::Coordinates GetStopCoordinates(StopId id) const {
+            return {stop_columns_.latitudes[id], stop_columns_.longitudes[id]};
+        }
+        //координаты с синусом и косинусом широты, посчитанными при добавлении остановки
+        geo::PreparedPoint GetStopPoint(StopId id) const {
+            return {stop_columns_.longitudes[id], stop_columns_.sin_latitudes[id], stop_columns_.cos_latitudes[id]};
+        }
+        //добавляет маршрут; остановки маршрута должны быть в справочнике
+        void AddBus(std::string_view number, const std::vector<const Stop*>& route, bool is_circle);
+        //номера остановок маршрута; действительны, пока в справочник не добавляются маршруты
+        RouteRange GetRoute(const Bus& bus) const;
         const Bus* FindBus(const std::string_view bus) const;               
     
-        //получить информацию о маршруте    
-        const BusInfo GetBusInfo(const std::string_view bus) const;         
+        //модель географических расстояний для статистики маршрутов, по умолчанию - точная GREAT_CIRCLE;
+        //задаётся до Finalize. Для FLAT_EARTH опорная широта - середина диапазона широт остановок
+        void SetDistanceModel(geo::DistanceModel model);
+    
+        //упорядочивает остановки и маршруты по названиям и вычисляет статистику всех маршрутов;
+        //вызывается после добавления остановок, расстояний и маршрутов
+        void Finalize();
+    
+        //получить информацию о маршруте (nullptr - маршрут не найден)
+        const BusInfo* GetBusInfo(const std::string_view bus) const;         
     
-        //поиск автобусов проходящих через остановку 
-        const std::unordered_set<const Bus*> FindBusesForStop(const std::string_view stop_name) const; 
+        //отсортированные номера автобусов, проходящих через остановку
+        using BusNamesRange = ranges::Range<std::vector<std::string_view>::const_iterator>;
     
-        //получить информацию об остановке
-        const std::set<std::string_view> GetStopInfo(const std::string_view stop_name) const;          
+        //получить информацию об остановке; списки автобусов строятся в Finalize
+        BusNamesRange GetStopInfo(const std::string_view stop_name) const;          
     
         //задать дистанцию между остановками
         void SetDistance(const Stop* from, const Stop* to, const int distance);                        
     
         //получить дистанцию между остановками
         int GetDistance(const Stop* from, const Stop* to) const;         
+        int GetDistance(StopId from, StopId to) const {
+            return distances_.Get(from, to);
+        }
     
-        //получить отсортированные маршруты
-        const std::map<std::string_view, const Bus*> GetSortedAllBuses() const;
+        //получить отсортированные маршруты; порядок действителен после Finalize
+        BusRange GetSortedAllBuses() const;
     
-        //получить отсортированные остановки
-        const std::map<std::string_view, const Stop*> GetSortedAllStops() const;
+        //получить отсортированные остановки; порядок действителен после Finalize
+        StopRange GetSortedAllStops() const;
     
     private:
+        //описатели остановок для FindStop и GetStop; данные остановок - в stop_columns_
         std::deque<Stop> stops_;                                                                       
         std::deque<Bus> buses_;                                                                        
     
+        StopColumns stop_columns_;
+    
+        //остановки всех маршрутов подряд, маршрут задаётся смещением и длиной
+        std::vector<StopId> route_stops_;
+    
+        //названия остановок и номера маршрутов
+        StringInterner names_;
+    
+        geo::DistanceModel distance_model_ = geo::DistanceModel::GREAT_CIRCLE;
+        geo::FlatEarthProjection flat_earth_;
+    
+        BusInfo ComputeBusInfo(const Bus& bus) const;
+        //географические длины отрезков маршрута по выбранной модели расстояния
+        std::vector<double> ComputeSegmentLengths(RouteRange route) const;
+    
         //индекс остановок(хеш - таблица)
         std::unordered_map<std::string_view, const Bus*> busname_to_bus_;                              
     
         //индекс маршрутов(хеш - таблица)
         std::unordered_map<std::string_view, const Stop*> stopname_to_stop_;                           
+    
+        //маршруты и остановки по возрастанию названий: пополняются в AddBus и AddStop,
+        //сортируются один раз в Finalize
+        std::vector<const Bus*> sorted_buses_;
+        std::vector<const Stop*> sorted_stops_;
         
-        //автобусы проходящие через остановку
-        std::unordered_map<const Stop*, std::unordered_set<const Bus*>> buses_for_stop_;               
+        //отсортированные номера автобусов по номеру остановки Stop::id
+        std::vector<std::vector<std::string_view>> bus_names_for_stop_;
     
-        //расстояние между остановками
-        std::unordered_map<std::pair<const Stop*, const Stop*>, int, StopPairHasher> distances_;       
+        //расстояние между остановками по их номерам Stop::id
+        DistanceTable distances_;       
 };
 } // namespace catalogue
@@ -1,49 +1,100 @@
+#define _USE_MATH_DEFINES
 #include "transport_router.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
 namespace catalogue {
-    //добавляет остановки в граф
-    void TransportRouter::AddStopsToGraph(graph::DirectedWeightedGraph<double>& stops_graph, std::map<std::string, graph::VertexId>& stop_ids, graph::VertexId& vertex_id, const catalogue::TransportCatalogue& catalogue) {
-        const auto& all_stops = catalogue.GetSortedAllStops(); 
+
+namespace {
+
+//Файл таблицы: заголовок, рёбра графа, имена рёбер подряд и таблица всех пар,
+//выровненная по 64 байтам, чтобы отображённые страницы читались как массив ячеек
+constexpr char CACHE_MAGIC[8] = {'T', 'C', 'R', 'O', 'U', 'T', 'E', 'R'};
+//в версии 3 таблица строилась блочным Флойдом - Уоршеллом и могла содержать циклы предыдущих рёбер
+constexpr uint32_t CACHE_VERSION = 4;
+constexpr uint64_t CACHE_ALIGNMENT = 64;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t cell_size;
+    uint32_t table_weight;
+    uint32_t reserved;
+    uint64_t key;
+    uint64_t vertex_count;
+    uint64_t edge_count;
+    uint64_t names_offset;
+    uint64_t names_size;
+    uint64_t table_offset;
+    uint64_t table_size;
+};
+
+struct CacheEdge {
+    uint64_t from;
+    uint64_t to;
+    uint64_t quality;
+    uint64_t name_offset;
+    uint64_t name_size;
+    double weight;
+};
+
+} // namespace
+
+    //добавляет остановки в граф: k-й по алфавиту остановке соответствуют вершины 2 * k и 2 * k + 1.
+    //Порядок вершин определяет выбор среди маршрутов одинакового времени, поэтому он не зависит от порядка добавления остановок
+    void TransportRouter::AddStopsToGraph(graph::DirectedWeightedGraph<double>& stops_graph, const catalogue::TransportCatalogue& catalogue) {
+        const auto all_stops = catalogue.GetSortedAllStops(); 
         
-        for (const auto& [stop_name, stop_info] : all_stops) {
-            stop_ids[stop_info->name] = vertex_id;
+        stop_ids_.clear();
+        stop_vertex_ids_.assign(catalogue.GetStopCount(), 0);
+        graph::VertexId vertex_id = 0;
+        for (const Stop* stop_info : all_stops) {
+            stop_ids_[stop_info->GetName()] = vertex_id;
+            stop_vertex_ids_[stop_info->id] = vertex_id;
             stops_graph.AddEdge({
-                stop_info->name,
+                stop_info->GetName(),
                 0,
                 vertex_id,
-                ++vertex_id,
+                vertex_id + 1,
                 static_cast<double>(GetBusWaitTime())
             });
-            ++vertex_id;
+            vertex_id += 2;
         }
     }
     
     //добавляет автобусы в граф
     void TransportRouter::AddBusesToGraph(graph::DirectedWeightedGraph<double>& stops_graph, const catalogue::TransportCatalogue& catalogue) {
-        const auto& all_buses = catalogue.GetSortedAllBuses();  
+        const auto all_buses = catalogue.GetSortedAllBuses();  
         
-        for (const auto& item : all_buses) {
-            const auto& bus_info = item.second;
-            const auto& route = bus_info->route;
+        for (const Bus* bus_info : all_buses) {
+            const RouteRange route = catalogue.GetRoute(*bus_info);
             size_t route_len = route.size();
 
+            //накопленные дорожные расстояния от начала маршрута в прямом и обратном направлении
+            std::vector<int> dist_prefix(route_len, 0);
+            std::vector<int> dist_prefix_inverse(route_len, 0);
+            for (size_t k = 1; k < route_len; ++k) {
+                dist_prefix[k] = dist_prefix[k - 1] + catalogue.GetDistance(route[k - 1], route[k]);
+                dist_prefix_inverse[k] = dist_prefix_inverse[k - 1] + catalogue.GetDistance(route[k], route[k - 1]);
+            }
+
             for (size_t i = 0; i < route_len; ++i) {
                 for (size_t j = i + 1; j < route_len; ++j) {
-                    const catalogue::Stop* stop_from = route[i];
-                    const catalogue::Stop* stop_to = route[j];
-                    int dist_sum = 0;
-                    int dist_sum_inverse = 0;
-
-                    for (size_t k = i + 1; k <= j; ++k) {
-                        dist_sum += catalogue.GetDistance(route[k - 1], route[k]);
-                        dist_sum_inverse += catalogue.GetDistance(route[k], route[k - 1]);
-                    }
+                    const graph::VertexId stop_from = stop_vertex_ids_[route[i]];
+                    const graph::VertexId stop_to = stop_vertex_ids_[route[j]];
+                    int dist_sum = dist_prefix[j] - dist_prefix[i];
+                    int dist_sum_inverse = dist_prefix_inverse[j] - dist_prefix_inverse[i];
 
                     stops_graph.AddEdge({
                         bus_info->number,
                         j - i,
-                        stop_ids_.at(stop_from->name) + 1,
-                        stop_ids_.at(stop_to->name),
+                        stop_from + 1,
+                        stop_to,
                         static_cast<double>(dist_sum) / (GetBusVelocity() * (100.0 / 6.0))
                     });
 
@@ -51,8 +102,8 @@ namespace catalogue {
                         stops_graph.AddEdge({
                             bus_info->number,
                             j - i,
-                            stop_ids_.at(stop_to->name) + 1,
-                            stop_ids_.at(stop_from->name),
+                            stop_to + 1,
+                            stop_from,
                             static_cast<double>(dist_sum_inverse) / (GetBusVelocity() * (100.0 / 6.0))
                         });
                     }
@@ -62,36 +113,432 @@ namespace catalogue {
     }    
 
 void TransportRouter::BuildGraph(const catalogue::TransportCatalogue& catalogue) {
-    const auto& all_stops = catalogue.GetSortedAllStops();     
-	graph::DirectedWeightedGraph<double> stops_graph(all_stops.size() * 2);
-    std::map<std::string, graph::VertexId> stop_ids;
-    graph::VertexId vertex_id = 0;
+    if (settings_.routing_mode_ == RoutingMode::RAPTOR) {
+        raptor_router_ = std::make_unique<RaptorRouter>(catalogue, GetBusWaitTime(), GetBusVelocity());
+        return;
+    }
+    if (settings_.routing_mode_ == RoutingMode::ALL_PAIRS && !settings_.cache_file_.empty() && LoadCache(catalogue)) {
+        return;
+    }
 
-    AddStopsToGraph(stops_graph, stop_ids, vertex_id, catalogue);
-    
-    stop_ids_ = std::move(stop_ids);
+	graph::DirectedWeightedGraph<double> stops_graph(catalogue.GetStopCount() * 2);
+
+    AddStopsToGraph(stops_graph, catalogue);
     
     AddBusesToGraph(stops_graph, catalogue);
     
     graph_ = std::move(stops_graph);
-    router_ = std::make_unique<graph::Router<double>>(graph_);
+    switch (settings_.routing_mode_) {
+        case RoutingMode::ALL_PAIRS:
+            MakeAllPairsRouter();
+            if (!settings_.cache_file_.empty()) {
+                SaveCache();
+            }
+            break;
+        case RoutingMode::DIJKSTRA:
+            compressed_graph_ = graph::CompressedGraph<double>(graph_);
+            dijkstra_router_ = std::make_unique<graph::DijkstraRouter<double>>(compressed_graph_);
+            break;
+        case RoutingMode::A_STAR:
+            compressed_graph_ = graph::CompressedGraph<double>(graph_);
+            dijkstra_router_ = std::make_unique<graph::DijkstraRouter<double>>(compressed_graph_);
+            PrepareHeuristic(catalogue);
+            break;
+        case RoutingMode::RAPTOR:
+            break;
+        case RoutingMode::SHORTEST_PATH_TREES:
+            compressed_graph_ = graph::CompressedGraph<double>(graph_);
+            dijkstra_router_ = std::make_unique<graph::DijkstraRouter<double>>(compressed_graph_);
+            tree_cache_ = std::make_unique<graph::ShortestPathTreeCache<double>>(compressed_graph_, *dijkstra_router_, settings_.tree_cache_size_);
+            break;
+        case RoutingMode::CONTRACTION_HIERARCHIES:
+            hierarchy_ = std::make_unique<graph::ContractionHierarchy<double>>(graph_);
+            //поиски из одной остановки во все (матрица времён) идут по обычному графу
+            compressed_graph_ = graph::CompressedGraph<double>(graph_);
+            dijkstra_router_ = std::make_unique<graph::DijkstraRouter<double>>(compressed_graph_);
+            break;
+    }
+}
+
+void TransportRouter::MakeAllPairsRouter(const char* table_data, size_t table_size, std::shared_ptr<const void> table_owner) {
+    const auto make_router = [&](auto router_type) {
+        using Router = typename decltype(router_type)::type;
+        if (table_data) {
+            router_ = std::make_unique<AllPairsRouter>(std::in_place_type<Router>, graph_, table_data, table_size, std::move(table_owner));
+        } else {
+            router_ = std::make_unique<AllPairsRouter>(std::in_place_type<Router>, graph_, settings_.router_threads_);
+        }
+    };
+    switch (settings_.table_weight_) {
+        case TableWeight::DOUBLE:
+            make_router(std::variant_alternative<0, AllPairsRouter>{});
+            break;
+        case TableWeight::FLOAT:
+            make_router(std::variant_alternative<1, AllPairsRouter>{});
+            break;
+        case TableWeight::FIXED_POINT:
+            make_router(std::variant_alternative<2, AllPairsRouter>{});
+            break;
+    }
+}
+
+bool TransportRouter::LoadCache(const catalogue::TransportCatalogue& catalogue) {
+    auto file = storage::MappedFile::Open(settings_.cache_file_);
+    if (!file || file->GetSize() < sizeof(CacheHeader)) {
+        return false;
+    }
+    CacheHeader header;
+    std::memcpy(&header, file->GetData(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+        || header.table_weight != static_cast<uint32_t>(settings_.table_weight_) || header.key != settings_.cache_key_) {
+        return false;
+    }
+    const uint64_t edges_size = header.edge_count * sizeof(CacheEdge);
+    if (header.vertex_count % 2 != 0 || sizeof(CacheHeader) + edges_size > header.names_offset
+        || header.names_offset + header.names_size > header.table_offset || header.table_offset % CACHE_ALIGNMENT != 0
+        || header.table_size != header.vertex_count * header.vertex_count * header.cell_size
+        || header.table_offset + header.table_size > file->GetSize()) {
+        return false;
+    }
+
+    const char* names = file->GetData() + header.names_offset;
+    graph::DirectedWeightedGraph<double> stops_graph(header.vertex_count);
+    for (uint64_t i = 0; i < header.edge_count; ++i) {
+        CacheEdge edge;
+        std::memcpy(&edge, file->GetData() + sizeof(CacheHeader) + i * sizeof(CacheEdge), sizeof(edge));
+        if (edge.from >= header.vertex_count || edge.to >= header.vertex_count || edge.name_offset + edge.name_size > header.names_size) {
+            return false;
+        }
+        //рёбра ссылаются на названия из справочника, а не на отображённый файл
+        const std::string_view name(names + edge.name_offset, edge.name_size);
+        const Stop* stop = edge.quality == 0 ? catalogue.FindStop(name) : nullptr;
+        const Bus* bus = edge.quality != 0 ? catalogue.FindBus(name) : nullptr;
+        if (!stop && !bus) {
+            return false;
+        }
+        stops_graph.AddEdge({stop ? stop->GetName() : bus->number, edge.quality, edge.from, edge.to, edge.weight});
+    }
+
+    graph_ = std::move(stops_graph);
+    //рёбра ожидания задают вершины остановок
+    stop_ids_.clear();
+    for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        if (edge.quality == 0) {
+            stop_ids_[edge.name] = edge.from;
+        }
+    }
+    const char* table = file->GetData() + header.table_offset;
+    try {
+        MakeAllPairsRouter(table, header.table_size, std::move(file));
+    } catch (const std::invalid_argument&) {
+        //таблица записана с другим размером ячейки
+        router_.reset();
+        return false;
+    }
+    return true;
 }
 
-const TransportRouter::RouteItems TransportRouter::GetRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const {
-    auto router_info = router_->BuildRoute(stop_ids_.at(std::string(stop_from)), stop_ids_.at(std::string(stop_to)));
-    graph::Router<double>::RouteInfo items_info;
+//пишет во временный файл и переименовывает его, чтобы читатели не увидели файл недописанным
+void TransportRouter::SaveCache() const {
+    std::vector<CacheEdge> edges;
+    edges.reserve(graph_.GetEdgeCount());
+    std::string names;
+    for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        edges.push_back({edge.from, edge.to, edge.quality, names.size(), edge.name.size(), edge.weight});
+        names += edge.name;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.cell_size = std::visit([](const auto& router) {
+        return static_cast<uint32_t>(router.GetTableCellSize());
+    }, *router_);
+    header.key = settings_.cache_key_;
+    header.vertex_count = graph_.GetVertexCount();
+    header.edge_count = edges.size();
+    header.names_offset = sizeof(CacheHeader) + edges.size() * sizeof(CacheEdge);
+    header.names_size = names.size();
+    header.table_offset = (header.names_offset + header.names_size + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+    header.table_weight = static_cast<uint32_t>(settings_.table_weight_);
+    header.table_size = std::visit([](const auto& router) {
+        return router.GetTableSize();
+    }, *router_);
+
+    const std::string temp_file = settings_.cache_file_ + ".tmp";
+    {
+        std::ofstream output(temp_file, std::ios::binary | std::ios::trunc);
+        const std::string padding(header.table_offset - header.names_offset - header.names_size, '\0');
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(CacheEdge));
+        output.write(names.data(), names.size());
+        output.write(padding.data(), padding.size());
+        std::visit([&output](const auto& router) {
+            router.WriteTable(output);
+        }, *router_);
+        if (!output) {
+            output.close();
+            std::remove(temp_file.c_str());
+            return;
+        }
+    }
+    //таблица не сохранилась - в следующий раз она будет построена заново
+    if (std::rename(temp_file.c_str(), settings_.cache_file_.c_str()) != 0) {
+        std::remove(temp_file.c_str());
+    }
+}
+
+graph::DijkstraRouter<double>::Workspace& TransportRouter::GetWorkspace() {
+    thread_local graph::DijkstraRouter<double>::Workspace workspace;
+    return workspace;
+}
+
+graph::ContractionHierarchy<double>::Workspace& TransportRouter::GetHierarchyWorkspace() {
+    thread_local graph::ContractionHierarchy<double>::Workspace workspace;
+    return workspace;
+}
+
+RaptorRouter::Workspace& TransportRouter::GetRaptorWorkspace() {
+    thread_local RaptorRouter::Workspace workspace;
+    return workspace;
+}
+
+//готовит оценку A*: расстояние на сфере, делённое на скорость автобуса.
+//Вместо дуги берётся хорда (она не длиннее дуги и считается без тригонометрии),
+//а дорожное расстояние может оказаться короче сферического, поэтому оценка
+//дополнительно умножается на наименьшее отношение дорожного расстояния к сферическому
+void TransportRouter::PrepareHeuristic(const catalogue::TransportCatalogue& catalogue) {
+    const double dr = M_PI / 180.0;
+    stop_points_.assign(catalogue.GetStopCount(), {});
+    for (StopId stop = 0; stop < catalogue.GetStopCount(); ++stop) {
+        //синус и косинус широты уже посчитаны справочником
+        const geo::PreparedPoint point = catalogue.GetStopPoint(stop);
+        const double lng = point.lng * dr;
+        stop_points_[stop_vertex_ids_[stop] / 2] = {point.cos_lat * std::cos(lng), point.cos_lat * std::sin(lng), point.sin_lat};
+    }
+
+    double min_ratio = 1.0;
+    for (const Bus* bus : catalogue.GetSortedAllBuses()) {
+        const RouteRange route = catalogue.GetRoute(*bus);
+        for (size_t i = 1; i < route.size(); ++i) {
+            const StopId from = route[i - 1];
+            const StopId to = route[i];
+            const double geo_distance = geo::ComputeDistance(catalogue.GetStopPoint(from), catalogue.GetStopPoint(to));
+            if (geo_distance > 0.0) {
+                min_ratio = std::min({min_ratio, catalogue.GetDistance(from, to) / geo_distance, catalogue.GetDistance(to, from) / geo_distance});
+            }
+        }
+    }
+    //запас на погрешность вычислений, чтобы оценка оставалась нижней
+    heuristic_scale_ = min_ratio * (1.0 - 1e-9) * 6371000 / (GetBusVelocity() * (100.0 / 6.0));
+}
+
+//нижняя оценка времени от вершины до вершины прибытия на остановку назначения
+double TransportRouter::GetLowerBound(graph::VertexId vertex, graph::VertexId vertex_to) const {
+    const size_t stop = vertex / 2;
+    const size_t stop_to = vertex_to / 2;
+    if (stop == stop_to) {
+        return 0.0;
+    }
+    const SpherePoint& point = stop_points_[stop];
+    const SpherePoint& point_to = stop_points_[stop_to];
+    const double dx = point.x - point_to.x;
+    const double dy = point.y - point_to.y;
+    const double dz = point.z - point_to.z;
+    double lower_bound = std::sqrt(dx * dx + dy * dy + dz * dz) * heuristic_scale_;
+    //с вершины прибытия на другую остановку нужно ещё дождаться автобуса
+    if (vertex % 2 == 0) {
+        lower_bound += GetBusWaitTime();
+    }
+    return lower_bound;
+}
+
+TransportRouter::RouteItems TransportRouter::GetRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const {
+    const auto start = std::chrono::steady_clock::now();
+    RouteItems route_items = raptor_router_ ? GetJourneyInfo(stop_from, stop_to) : GetGraphRouteInfo(stop_from, stop_to);
+    const auto query_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    std::lock_guard lock(query_stats_mutex_);
+    ++query_stats_.query_count;
+    query_stats_.query_time += query_time;
+    query_stats_.settled_vertex_count += route_items.settled_vertices_;
+    return route_items;
+}
+
+TransportRouter::RouteItems TransportRouter::GetGraphRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const {
+    auto& workspace = GetWorkspace();
+    const graph::VertexId vertex_from = stop_ids_.at(stop_from);
+    const graph::VertexId vertex_to = stop_ids_.at(stop_to);
+    std::optional<graph::Router<double>::RouteInfo> router_info;
+    size_t settled_vertices = 0;
+    if (router_) {
+        router_info = std::visit([vertex_from, vertex_to](const auto& router) {
+            return router.BuildRoute(vertex_from, vertex_to);
+        }, *router_);
+    } else if (tree_cache_) {
+        //поиски при построении деревьев учитываются в статистике кэша
+        router_info = tree_cache_->BuildRoute(vertex_from, vertex_to, workspace);
+    } else if (hierarchy_) {
+        auto& hierarchy_workspace = GetHierarchyWorkspace();
+        router_info = hierarchy_->BuildRoute(vertex_from, vertex_to, hierarchy_workspace);
+        settled_vertices = hierarchy_workspace.forward.GetSettledCount() + hierarchy_workspace.backward.GetSettledCount();
+    } else if (settings_.routing_mode_ == RoutingMode::A_STAR) {
+        router_info = dijkstra_router_->BuildRoute(vertex_from, vertex_to, workspace, [this, vertex_to](graph::VertexId vertex) {
+            return GetLowerBound(vertex, vertex_to);
+        });
+        settled_vertices = workspace.GetSettledCount();
+    } else {
+        router_info = dijkstra_router_->BuildRoute(vertex_from, vertex_to, workspace);
+        settled_vertices = workspace.GetSettledCount();
+    }
+    if (!router_info) {
+        return RouteItems{std::nullopt, nullptr, nullptr, settled_vertices};
+    }
+    return RouteItems{std::move(router_info), &graph_, nullptr, settled_vertices};
+}
     
-    if (router_info) {
-        items_info.weight = router_info.value().weight;
-        for (const auto& edge : router_info.value().edges) {
-                items_info.edges.push_back(edge);
+TransportRouter::TravelTimeMatrix TransportRouter::GetTravelTimeMatrix(const std::vector<std::string_view>& stops_from, const std::vector<std::string_view>& stops_to) const {
+    TravelTimeMatrix matrix{stops_from.size(), stops_to.size(), {}};
+    matrix.times.reserve(stops_from.size() * stops_to.size());
+
+    if (raptor_router_) {
+        auto& raptor_workspace = GetRaptorWorkspace();
+        for (const auto stop_from : stops_from) {
+            raptor_router_->ComputeArrivals(stop_from, raptor_workspace);
+            for (const auto stop_to : stops_to) {
+                matrix.times.push_back(raptor_router_->GetArrivalTime(stop_to, raptor_workspace));
+            }
+        }
+        return matrix;
+    }
+
+    auto& workspace = GetWorkspace();
+    std::vector<graph::VertexId> vertices_to;
+    vertices_to.reserve(stops_to.size());
+    for (const auto stop_to : stops_to) {
+        vertices_to.push_back(stop_ids_.at(stop_to));
+    }
+    for (const auto stop_from : stops_from) {
+        const graph::VertexId vertex_from = stop_ids_.at(stop_from);
+        if (router_) {
+            std::visit([&matrix, &vertices_to, vertex_from](const auto& router) {
+                for (const graph::VertexId vertex_to : vertices_to) {
+                    matrix.times.push_back(router.GetRouteWeight(vertex_from, vertex_to).value_or(std::numeric_limits<double>::infinity()));
+                }
+            }, *router_);
+            continue;
+        }
+        if (tree_cache_) {
+            const auto tree = tree_cache_->GetTree(vertex_from, workspace);
+            for (const graph::VertexId vertex_to : vertices_to) {
+                matrix.times.push_back(tree->weights[vertex_to]);
             }
-        return RouteItems{items_info, &graph_};
+            continue;
+        }
+        dijkstra_router_->BuildTree(vertex_from, workspace);
+        for (const graph::VertexId vertex_to : vertices_to) {
+            matrix.times.push_back(workspace.IsReached(vertex_to) ? workspace.GetWeight(vertex_to) : std::numeric_limits<double>::infinity());
+        }
+    }
+    return matrix;
+}
+
+std::vector<TransportRouter::ReachableStop> TransportRouter::GetReachableStops(const std::string_view stop_from, double max_time) const {
+    std::vector<ReachableStop> result;
+    if (raptor_router_) {
+        auto& raptor_workspace = GetRaptorWorkspace();
+        raptor_router_->ComputeArrivals(stop_from, raptor_workspace, max_time);
+        for (const Stop* stop : raptor_router_->GetStops()) {
+            const double time = raptor_router_->GetArrivalTime(stop->GetName(), raptor_workspace);
+            if (time <= max_time) {
+                result.push_back({stop->GetName(), time});
+            }
+        }
     } else {
+        auto& workspace = GetWorkspace();
+        const graph::VertexId vertex_from = stop_ids_.at(stop_from);
+        std::shared_ptr<const graph::ShortestPathTreeCache<double>::Tree> tree;
+        if (tree_cache_) {
+            tree = tree_cache_->GetTree(vertex_from, workspace);
+        } else if (!router_) {
+            dijkstra_router_->BuildTree(vertex_from, workspace, max_time);
+        }
+        for (const auto& [stop_name, vertex_id] : stop_ids_) {
+            std::optional<double> time;
+            if (router_) {
+                time = std::visit([vertex_from, vertex_id = vertex_id](const auto& router) {
+                    return router.GetRouteWeight(vertex_from, vertex_id);
+                }, *router_);
+            } else if (tree) {
+                if (tree->IsReached(vertex_id)) {
+                    time = tree->weights[vertex_id];
+                }
+            } else if (workspace.IsReached(vertex_id)) {
+                time = workspace.GetWeight(vertex_id);
+            }
+            if (time && *time <= max_time) {
+                result.push_back({stop_name, *time});
+            }
+        }
+    }
+    //при равном времени - по алфавиту
+    std::sort(result.begin(), result.end(), [](const ReachableStop& lhs, const ReachableStop& rhs) {
+        return lhs.time < rhs.time || (lhs.time == rhs.time && lhs.stop_name < rhs.stop_name);
+    });
+    return result;
+}
+
+TransportRouter::RoutingStats TransportRouter::GetRoutingStats() const {
+    RoutingStats stats;
+    {
+        std::lock_guard lock(query_stats_mutex_);
+        stats = query_stats_;
+    }
+    if (hierarchy_) {
+        stats.preprocessing_time = hierarchy_->GetStats().preprocessing_time;
+        stats.shortcut_count = hierarchy_->GetStats().shortcut_count;
+    }
+    if (tree_cache_) {
+        const auto cache_stats = tree_cache_->GetStats();
+        stats.settled_vertex_count += cache_stats.settled_vertex_count;
+        stats.tree_cache_hit_count = cache_stats.hit_count;
+        stats.tree_cache_miss_count = cache_stats.miss_count;
+        stats.tree_cache_eviction_count = cache_stats.eviction_count;
+        stats.tree_cache_memory_bytes = cache_stats.memory_bytes;
+    }
+    return stats;
+}
+
+//переводит поездки RAPTOR в рёбра ожидания и проезда, как в общем графе
+TransportRouter::RouteItems TransportRouter::GetJourneyInfo(const std::string_view stop_from, const std::string_view stop_to) const {
+    const auto journey = raptor_router_->BuildRoute(stop_from, stop_to, GetRaptorWorkspace());
+    if (!journey) {
         return RouteItems{std::nullopt, nullptr};
     }
 
-    return RouteItems{items_info, &graph_};
+    auto journey_graph = std::make_shared<graph::DirectedWeightedGraph<double>>(journey->legs.size() * 2 + 1);
+    graph::Router<double>::RouteInfo items_info{journey->total_time, {}};
+    graph::VertexId vertex_id = 0;
+    for (const auto& leg : journey->legs) {
+        items_info.edges.push_back(journey_graph->AddEdge({
+            leg.stop_from->GetName(),
+            0,
+            vertex_id,
+            vertex_id + 1,
+            static_cast<double>(GetBusWaitTime())
+        }));
+        items_info.edges.push_back(journey_graph->AddEdge({
+            leg.bus->number,
+            leg.span_count,
+            vertex_id + 1,
+            vertex_id + 2,
+            leg.ride_time
+        }));
+        vertex_id += 2;
+    }
+
+    return RouteItems{std::move(items_info), journey_graph.get(), journey_graph};
 }
-    
+
 }
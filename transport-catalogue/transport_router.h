@@ -1,25 +1,120 @@
 #pragma once
 
+#include "contraction_hierarchy.h"
+#include "dijkstra_router.h"
+#include "mapped_file.h"
+#include "raptor_router.h"
 #include "router.h"
+#include "shortest_path_tree_cache.h"
 #include "transport_catalogue.h"
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
 
 namespace catalogue {
 
 class TransportRouter {
 public:
 
+    //способ поиска маршрута
+    enum class RoutingMode {
+        ALL_PAIRS,  //таблица всех пар при построении (Флойд - Уоршелл)
+        DIJKSTRA,   //поиск Дейкстры на каждый запрос
+        A_STAR,     //поиск A* с оценкой по расстоянию на сфере до цели
+        RAPTOR,     //поиск по раундам по маршрутам автобусов, без графа
+        CONTRACTION_HIERARCHIES, //иерархия сжатия и двунаправленный поиск вверх
+        SHORTEST_PATH_TREES      //дерево кратчайших путей на остановку отправления в кэше LRU
+    };
+
+    //тип весов в таблице всех пар: double (16 байт на ячейку), float или
+    //фиксированная точка 1/1024 минуты (по 8 байт на ячейку)
+    enum class TableWeight {
+        DOUBLE,
+        FLOAT,
+        FIXED_POINT
+    };
+
     struct Settings {
         int bus_wait_time_ = 0;
         double bus_velocity_ = 0.0;
+        RoutingMode routing_mode_ = RoutingMode::ALL_PAIRS;
+        //потоки для построения таблицы всех пар (0 - по числу ядер)
+        size_t router_threads_ = 1;
+        TableWeight table_weight_ = TableWeight::DOUBLE;
+        //сколько деревьев кратчайших путей держать в кэше
+        size_t tree_cache_size_ = 64;
+        //файл с сохранённой таблицей всех пар (пусто - не сохранять)
+        std::string cache_file_;
+        //отпечаток исходных данных; таблица из файла с другим ключом не используется
+        uint64_t cache_key_ = 0;
     };
 
-    using RouteInfo = graph::Router<double>::RouteInfo;
+    using RouteInfo = graph::Route<double>;
     
+    //найденный маршрут: номера рёбер и граф, которому они принадлежат.
+    //Рёбра не копируются, а читаются из графа по номеру
     struct RouteItems {
         std::optional<RouteInfo> route_info_;
-        const graph::DirectedWeightedGraph<double>* route_graph_;
+        const graph::DirectedWeightedGraph<double>* route_graph_ = nullptr;
+        //граф из рёбер найденного маршрута в режиме RAPTOR, на него указывает route_graph_
+        std::shared_ptr<const graph::DirectedWeightedGraph<double>> journey_graph_ = nullptr;
+        //число окончательно обработанных вершин в поиске (Дейкстра, A*, иерархия сжатия)
+        size_t settled_vertices_ = 0;
+
+        explicit operator bool() const {
+            return route_info_.has_value();
+        }
+
+        double GetTotalTime() const {
+            return route_info_->weight;
+        }
+
+        size_t GetItemCount() const {
+            return route_info_->edges.size();
+        }
+
+        //ребро маршрута: ожидание (quality == 0) или поездка на автобусе
+        const graph::Edge<double>& GetItem(size_t index) const {
+            return route_graph_->GetEdge(route_info_->edges[index]);
+        }
+    };
+
+    //статистика предобработки и запросов
+    struct RoutingStats {
+        std::chrono::nanoseconds preprocessing_time{0};
+        size_t shortcut_count = 0;
+        size_t query_count = 0;
+        std::chrono::nanoseconds query_time{0};
+        size_t settled_vertex_count = 0;
+        //кэш деревьев кратчайших путей
+        size_t tree_cache_hit_count = 0;
+        size_t tree_cache_miss_count = 0;
+        size_t tree_cache_eviction_count = 0;
+        size_t tree_cache_memory_bytes = 0;
+    };
+
+    //матрица времён в пути: строка на остановку отправления, столбец на остановку назначения,
+    //бесконечность - маршрута нет
+    struct TravelTimeMatrix {
+        size_t row_count = 0;
+        size_t column_count = 0;
+        std::vector<double> times;
+
+        double Get(size_t row, size_t column) const {
+            return times[row * column_count + column];
+        }
+    };
+
+    //остановка, достижимая в пределах заданного времени
+    struct ReachableStop {
+        std::string_view stop_name;
+        double time;
     };
 
     TransportRouter() = default;
@@ -29,7 +124,16 @@ public:
         BuildGraph(catalogue);
     }
 
-    const RouteItems GetRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const;
+    RouteItems GetRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const;
+
+    //времена в пути для всех пар остановок: один поиск на остановку отправления, без восстановления маршрутов
+    TravelTimeMatrix GetTravelTimeMatrix(const std::vector<std::string_view>& stops_from, const std::vector<std::string_view>& stops_to) const;
+
+    //остановки, достижимые из stop_from не дольше чем за max_time (по возрастанию времени);
+    //считается одним поиском, который не продолжается за пределами max_time
+    std::vector<ReachableStop> GetReachableStops(const std::string_view stop_from, double max_time) const;
+
+    RoutingStats GetRoutingStats() const;
     
 protected:    
     
@@ -47,12 +151,57 @@ private:
     Settings settings_;
 
     graph::DirectedWeightedGraph<double> graph_;        
-    std::map<std::string, graph::VertexId> stop_ids_;
-    std::unique_ptr<graph::Router<double>> router_;        
+    graph::CompressedGraph<double> compressed_graph_;
+    //вершина прибытия остановки по её названию
+    std::unordered_map<std::string_view, graph::VertexId> stop_ids_;
+    //вершина прибытия остановки по Stop::id
+    std::vector<graph::VertexId> stop_vertex_ids_;
+    //таблица всех пар с выбранным в settings_.table_weight_ типом весов
+    using AllPairsRouter = std::variant<graph::Router<double>, graph::Router<double, float>, graph::Router<double, graph::FixedPointMinutes>>;
+    std::unique_ptr<AllPairsRouter> router_;        
+    std::unique_ptr<graph::DijkstraRouter<double>> dijkstra_router_;
+    std::unique_ptr<graph::ContractionHierarchy<double>> hierarchy_;
+    std::unique_ptr<graph::ShortestPathTreeCache<double>> tree_cache_;
+    std::unique_ptr<RaptorRouter> raptor_router_;
+    mutable std::mutex query_stats_mutex_;
+    mutable RoutingStats query_stats_;
 
-    void AddStopsToGraph(graph::DirectedWeightedGraph<double>& stops_graph, std::map<std::string, graph::VertexId>& stop_ids, graph::VertexId& vertex_id, const catalogue::TransportCatalogue& catalogue);
+    //точки остановок на единичной сфере по номеру вершины, делённому на 2, для оценки A*
+    struct SpherePoint {
+        double x;
+        double y;
+        double z;
+    };
+    std::vector<SpherePoint> stop_points_;
+    //перевод длины хорды на единичной сфере в нижнюю оценку времени в пути
+    double heuristic_scale_ = 0.0;
+
+    void AddStopsToGraph(graph::DirectedWeightedGraph<double>& stops_graph, const catalogue::TransportCatalogue& catalogue);
         
     void AddBusesToGraph(graph::DirectedWeightedGraph<double>& stops_graph, const catalogue::TransportCatalogue& catalogue);
+
+    void PrepareHeuristic(const catalogue::TransportCatalogue& catalogue);
+
+    //буферы поиска свои у каждого потока, поэтому запросы можно выполнять параллельно
+    static graph::DijkstraRouter<double>::Workspace& GetWorkspace();
+    static graph::ContractionHierarchy<double>::Workspace& GetHierarchyWorkspace();
+    static RaptorRouter::Workspace& GetRaptorWorkspace();
+
+    double GetLowerBound(graph::VertexId vertex, graph::VertexId vertex_to) const;
+
+    //строит таблицу всех пар по graph_ или берёт готовую из table_data
+    void MakeAllPairsRouter(const char* table_data = nullptr, size_t table_size = 0, std::shared_ptr<const void> table_owner = nullptr);
+
+    //загружает граф и таблицу всех пар из settings_.cache_file_, false - файла нет или он не подходит
+    //названия в рёбрах загруженного графа берутся из catalogue
+    bool LoadCache(const catalogue::TransportCatalogue& catalogue);
+
+    //сохраняет граф и таблицу всех пар в settings_.cache_file_
+    void SaveCache() const;
+
+    RouteItems GetGraphRouteInfo(const std::string_view stop_from, const std::string_view stop_to) const;
+
+    RouteItems GetJourneyInfo(const std::string_view stop_from, const std::string_view stop_to) const;
 };
     
 }